@@ -0,0 +1,594 @@
+/// \file benchmark.cpp
+/// \brief Zawiera zestaw testw wydajnoci (Google Benchmark) dla wczytywania, zapyta i serializacji danych.
+/// \details Dane wejciowe to syntetyczne serie 15-minutowe o dugoci od 1 miesica do 50 lat, generowane
+/// deterministycznie. Wyniki s domylnie zapisywane take do pliku benchmark_results.json, aby mona byo
+/// porwnywa je midzy kompilacjami. Kady test raportuje licznik rss_growth_mb - przyrost zuycia pamici (RSS)
+/// w czasie jego przygotowania i ptli pomiarowej, niezaleny od testw uruchomionych wczeniej.
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../P6/Timestamp.h"
+#include "../P6/Timestamp.cpp"
+#include "../P6/RowData.h"
+#include "../P6/RowData.cpp"
+#include "../P6/ColumnStore.h"
+#include "../P6/ColumnStore.cpp"
+#include "../P6/PrefixSumIndex.h"
+#include "../P6/PrefixSumIndex.cpp"
+#include "../P6/Aggregate.h"
+#include "../P6/Aggregate.cpp"
+#include "../P6/AggregateKernels.h"
+#include "../P6/AggregateKernels.cpp"
+#include "../P6/Snapshot.h"
+#include "../P6/Snapshot.cpp"
+#include "../P6/MappedFile.h"
+#include "../P6/MappedFile.cpp"
+#include "../P6/IndexFile.h"
+#include "../P6/IndexFile.cpp"
+#include "../P6/ThreadPool.h"
+#include "../P6/ThreadPool.cpp"
+#include "../P6/RangeView.h"
+#include "../P6/RangeView.cpp"
+#include "../P6/TreeData.h"
+#include "../P6/TreeData.cpp"
+#include "../P6/LogManager.h"
+#include "../P6/LogManager.cpp"
+#include "../P6/LineValidation.h"
+#include "../P6/CsvParser.h"
+#include "../P6/CsvParser.cpp"
+#include "../P6/CsvFollower.h"
+#include "../P6/CsvFollower.cpp"
+#include "../P6/MultiSiteData.h"
+#include "../P6/MultiSiteData.cpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/// \brief Zwraca biece zuycie pamici (RSS) procesu w megabajtach.
+static double currentRssMegabytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize / (1024.0 * 1024.0);
+    }
+    return 0.0;
+#else
+    long pages = 0, residentPages = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm != nullptr) {
+        if (fscanf(statm, "%ld %ld", &pages, &residentPages) != 2) {
+            residentPages = 0;
+        }
+        fclose(statm);
+    }
+    return residentPages * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+#endif
+}
+
+/// \brief Zwraca szczytowe zuycie pamici (RSS) procesu w megabajtach (od startu albo od resetPeakRss).
+static double peakRssMegabytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+    }
+    return 0.0;
+#else
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return atof(line.c_str() + 6) / 1024.0;  ///< Warto w kilobajtach
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;  ///< Linux podaje ru_maxrss w kilobajtach
+#endif
+}
+
+/// \brief Zeruje szczytowe zuycie pamici procesu (ustawia je na biece).
+/// \return true, jeli system na to pozwala (Linux od wersji 4.0); Windows nie udostpnia takiej operacji.
+static bool resetPeakRss() {
+#ifdef _WIN32
+    return false;
+#else
+    FILE* clearRefs = fopen("/proc/self/clear_refs", "w");
+    if (clearRefs == nullptr) {
+        return false;
+    }
+    bool reset = fputs("5", clearRefs) >= 0;
+    return fclose(clearRefs) == 0 && reset;
+#endif
+}
+
+/// \class RssMeter
+/// \brief Mierzy przyrost zuycia pamici w czasie jednego testu i zapisuje go w liczniku rss_growth_mb.
+/// Obiekt tworzony na pocztku funkcji testu zapamituje biece RSS i zeruje szczyt procesu, a przy
+/// zniszczeniu zapisuje rnic midzy szczytem w czasie testu a RSS na pocztku. Jeli szczytu nie da si
+/// wyzerowa (Windows), uywany jest szczyt procesu, o ile test go podnis, a w przeciwnym razie RSS na kocu
+/// testu - pami zwolniona przed kocem testu nie jest wtedy widoczna. Pami zwolniona przez wczeniejsze testy,
+/// ale zatrzymana przez alokator, jest uywana ponownie i nie zwiksza wyniku.
+class RssMeter {
+public:
+    /// \brief Rozpoczyna pomiar dla podanego testu.
+    explicit RssMeter(benchmark::State& state)
+        : state(state), baseline(currentRssMegabytes()), peakReset(resetPeakRss()), peakBefore(peakRssMegabytes()) {
+    }
+
+    /// \brief Koczy pomiar i zapisuje licznik rss_growth_mb.
+    ~RssMeter() {
+        double peak = peakRssMegabytes();
+        double top = peakReset || peak > peakBefore ? peak : currentRssMegabytes();
+        state.counters["rss_growth_mb"] = top > baseline ? top - baseline : 0.0;
+    }
+
+    RssMeter(const RssMeter&) = delete;
+    RssMeter& operator=(const RssMeter&) = delete;
+
+private:
+    benchmark::State& state; ///< Test, dla ktrego zapisywany jest licznik.
+    double baseline; ///< RSS na pocztku testu.
+    bool peakReset; ///< Czy szczyt procesu zosta wyzerowany.
+    double peakBefore; ///< Szczyt procesu na pocztku testu.
+};
+
+/// \brief Zwraca znacznik czasu pocztku danych syntetycznych (01.01.2000 00:00).
+static int32_t seriesStart() {
+    return makeTimestamp(2000, 1, 1, 0, 0);
+}
+
+/// \brief Generuje syntetyczn seri 15-minutow.
+/// \param months Dugo serii w miesicach.
+/// \param site Numer instalacji - inne ziarno generatora dla kadej instalacji.
+/// \return Wiersze serii w kolejnoci chronologicznej.
+/// \details Produkcja ma dzienny przebieg zbliony do sinusoidy, a pobr jest losowy wok staego poziomu.
+static vector<RowData> generateRows(int months, int site) {
+    int32_t start = seriesStart();
+    int32_t end = makeTimestamp(2000 + months / 12, months % 12 + 1, 1, 0, 0);
+    mt19937 generator(1234u + site);
+    uniform_real_distribution<float> noise(0.0f, 1.0f);
+
+    vector<RowData> rows;
+    rows.reserve((end - start) / 15);
+    for (int32_t timestamp = start; timestamp < end; timestamp += 15) {
+        int minuteOfDay = (timestamp - start) % 1440;
+        float sun = minuteOfDay > 360 && minuteOfDay < 1080 ? (1.0f - fabsf(minuteOfDay - 720.0f) / 360.0f) : 0.0f;
+        float production = 4000.0f * sun * (0.6f + 0.4f * noise(generator));
+        float consumption = 300.0f + 900.0f * noise(generator);
+        float selfConsumption = production < consumption ? production : consumption;
+        rows.emplace_back(timestamp, selfConsumption, production - selfConsumption, consumption - selfConsumption,
+            consumption, production);
+    }
+    return rows;
+}
+
+/// \brief Zwraca (i zapamituje) seri syntetyczn o podanej dugoci.
+static const vector<RowData>& cachedRows(int months, int site = 0) {
+    static map<pair<int, int>, vector<RowData>> cache;
+    auto it = cache.find({ months, site });
+    if (it == cache.end()) {
+        it = cache.emplace(make_pair(months, site), generateRows(months, site)).first;
+    }
+    return it->second;
+}
+
+/// \brief Zwraca (i zapamituje) seri syntetyczn zapisan w formacie eksportu CSV.
+static const string& cachedCsv(int months) {
+    static map<int, string> cache;
+    auto it = cache.find(months);
+    if (it == cache.end()) {
+        string csv = "Time,Autokonsumpcja (W),Eksport (W),Import (W),Pobor (W),Produkcja (W)\n";
+        char line[128];
+        for (const auto& rowData : cachedRows(months)) {
+            int length = snprintf(line, sizeof(line), "%s,%.3f,%.3f,%.3f,%.3f,%.3f\n", rowData.getDate().c_str(),
+                rowData.getSelfConsumption(), rowData.getExport(), rowData.getImport(),
+                rowData.getConsumption(), rowData.getProduction());
+            csv.append(line, length);
+        }
+        it = cache.emplace(months, move(csv)).first;
+    }
+    return it->second;
+}
+
+/// \brief Zwraca (i zapamituje) drzewo wypenione seri o podanej dugoci.
+static const TreeData& cachedTree(int months) {
+    static map<int, unique_ptr<TreeData>> cache;
+    auto it = cache.find(months);
+    if (it == cache.end()) {
+        unique_ptr<TreeData> treeData(new TreeData());
+        for (const auto& rowData : cachedRows(months)) {
+            treeData->addData(rowData);
+        }
+        it = cache.emplace(months, move(treeData)).first;
+    }
+    return *it->second;
+}
+
+/// \brief Parsowanie bufora CSV (jeden wtek) wraz z walidacj i logowaniem odrzuconych wierszy.
+static void BM_CsvParse(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const string& csv = cachedCsv(static_cast<int>(state.range(0)));
+    size_t rows = 0;
+    for (auto _ : state) {
+        CsvParser parser;
+        parser.parseBuffer(csv.data(), csv.size(), [&rows](const RowData&) { ++rows; });
+        benchmark::DoNotOptimize(rows);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * csv.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(rows));
+}
+BENCHMARK(BM_CsvParse)->ArgName("months")->Arg(1)->Arg(12)->Arg(120)->Arg(600)->Unit(benchmark::kMillisecond);
+
+/// \brief Rwnolege parsowanie bufora CSV.
+static void BM_CsvParseParallel(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const string& csv = cachedCsv(static_cast<int>(state.range(0)));
+    size_t rows = 0;
+    for (auto _ : state) {
+        CsvParser parser;
+        parser.parseBufferParallel(csv.data(), csv.size(), [&rows](const RowData&) { ++rows; });
+        benchmark::DoNotOptimize(rows);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * csv.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(rows));
+}
+BENCHMARK(BM_CsvParseParallel)->ArgName("months")->Arg(120)->Arg(600)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// \brief Odwieenie drzewa 10-letniej serii po dopisaniu do pliku CSV jednego wiersza (tryb ledzenia pliku).
+static void BM_FollowerPoll(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const string path = "benchmark_follow.csv";
+    {
+        ofstream out(path, ios::binary | ios::trunc);
+        out << cachedCsv(120);
+    }
+    TreeData treeData;
+    CsvFollower follower(path);
+    auto addRow = [&treeData](const RowData& rowData) { treeData.addDataUnique(rowData); };
+    follower.poll(addRow);  ///< Pierwsze wczytanie caej historii poza pomiarem
+
+    int32_t timestamp = follower.getLastTimestamp();
+    char line[128];
+    for (auto _ : state) {
+        state.PauseTiming();
+        timestamp += 15;
+        int length = snprintf(line, sizeof(line), "%s,1.000,2.000,3.000,4.000,5.000\n", formatTimestamp(timestamp).c_str());
+        {
+            ofstream out(path, ios::binary | ios::app);
+            out.write(line, length);
+        }
+        state.ResumeTiming();
+        follower.poll(addRow);
+    }
+    state.counters["rows"] = static_cast<double>(treeData.size());
+    remove(path.c_str());
+}
+BENCHMARK(BM_FollowerPoll)->Unit(benchmark::kMicrosecond);
+
+/// \brief Walidacja pojedynczych wierszy funkcj lineValidation.
+static void BM_LineValidation(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const string& csv = cachedCsv(12);
+    vector<string> lines;
+    istringstream stream(csv);
+    getline(stream, lines.emplace_back());  ///< Nagwek - odrzucany i logowany przy kadym przebiegu
+    for (string line; getline(stream, line);) {
+        lines.push_back(line);
+    }
+    for (auto _ : state) {
+        size_t valid = 0;
+        for (const auto& line : lines) {
+            valid += lineValidation(line);
+        }
+        benchmark::DoNotOptimize(valid);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * lines.size()));
+}
+BENCHMARK(BM_LineValidation)->Unit(benchmark::kMillisecond);
+
+/// \brief Przepustowo addData dla kilku instalacji, kada we wasnym drzewie.
+static void BM_AddData(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    int months = static_cast<int>(state.range(0));
+    int sites = static_cast<int>(state.range(1));
+    size_t rows = 0;
+    for (int site = 0; site < sites; ++site) {
+        rows += cachedRows(months, site).size();
+    }
+    for (auto _ : state) {
+        vector<TreeData> trees(sites);
+        for (int site = 0; site < sites; ++site) {
+            for (const auto& rowData : cachedRows(months, site)) {
+                trees[site].addData(rowData);
+            }
+        }
+        benchmark::DoNotOptimize(trees.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+}
+BENCHMARK(BM_AddData)->ArgNames({ "months", "sites" })
+    ->Args({ 1, 1 })->Args({ 12, 1 })->Args({ 120, 1 })->Args({ 600, 1 })->Args({ 120, 4 })
+    ->Unit(benchmark::kMillisecond);
+
+/// \brief Wczytanie paczki serii kilku instalacji na wspln o czasu i ich miesiczna suma zbiorcza.
+static void BM_MultiSiteTotals(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    int months = static_cast<int>(state.range(0));
+    int siteCount = static_cast<int>(state.range(1));
+    vector<MultiSiteData::SiteRows> batch;
+    for (int site = 0; site < siteCount; ++site) {
+        batch.push_back({ "site" + to_string(site), cachedRows(months, site) });
+    }
+    for (auto _ : state) {
+        MultiSiteData sites;
+        sites.addSeries(batch);
+        Aggregate totals = sites.calculateStatsBetweenDates(MultiSiteData::SiteSet(), "01.03.2000 00:00", "31.03.2000 23:59");
+        benchmark::DoNotOptimize(totals.count);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size() * batch.front().rows.size()));
+}
+BENCHMARK(BM_MultiSiteTotals)->ArgNames({ "months", "sites" })->Args({ 12, 1 })->Args({ 12, 4 })->Args({ 12, 16 })
+    ->Unit(benchmark::kMillisecond);
+
+/// \brief Przepustowo addBatch dla uporzdkowanej serii (dopisanie na koniec) i dla serii odwrconej (sortowanie i scalanie).
+static void BM_AddBatch(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    int months = static_cast<int>(state.range(0));
+    bool reversed = state.range(1) != 0;
+    vector<RowData> rows = cachedRows(months);
+    if (reversed) {
+        reverse(rows.begin(), rows.end());
+    }
+    for (auto _ : state) {
+        TreeData treeData;
+        treeData.addBatch(rows);
+        benchmark::DoNotOptimize(treeData.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows.size()));
+}
+BENCHMARK(BM_AddBatch)->ArgNames({ "months", "reversed" })
+    ->Args({ 12, 0 })->Args({ 120, 0 })->Args({ 600, 0 })->Args({ 120, 1 })
+    ->Unit(benchmark::kMillisecond);
+
+/// \brief Zwraca kolejne daty pocztkowe zapyta, rozoone rwnomiernie w 10-letniej serii.
+/// \param iteration Numer zapytania.
+/// \param windowDays Szeroko okna w dniach.
+/// \param[out] startDate Data pocztkowa.
+/// \param[out] endDate Data kocowa (wcznie).
+static void queryWindow(size_t iteration, int windowDays, string& startDate, string& endDate) {
+    const int seriesDays = 3650 - windowDays;
+    int32_t start = seriesStart() + static_cast<int32_t>((iteration * 7919) % seriesDays) * 1440;
+    startDate = formatTimestamp(start);
+    endDate = formatTimestamp(start + windowDays * 1440 - 1);
+}
+
+/// \brief Pobieranie wierszy z okna o podanej szerokoci (w dniach) z serii 10-letniej.
+static void BM_GetDataBetweenDates(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const TreeData& treeData = cachedTree(120);
+    int windowDays = static_cast<int>(state.range(0));
+    string startDate, endDate;
+    size_t iteration = 0, rows = 0;
+    for (auto _ : state) {
+        queryWindow(iteration++, windowDays, startDate, endDate);
+        vector<RowData> result = treeData.getDataBetweenDates(startDate, endDate);
+        rows += result.size();
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(rows));
+}
+BENCHMARK(BM_GetDataBetweenDates)->ArgName("days")->Arg(1)->Arg(7)->Arg(30)->Arg(365);
+
+/// \brief Przegldanie wierszy okna przez widok (bez kopiowania) z serii 10-letniej.
+static void BM_ViewBetweenDates(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const TreeData& treeData = cachedTree(120);
+    int windowDays = static_cast<int>(state.range(0));
+    string startDate, endDate;
+    size_t iteration = 0, rows = 0;
+    for (auto _ : state) {
+        queryWindow(iteration++, windowDays, startDate, endDate);
+        float total = 0.0f;
+        for (RangeView::Row row : treeData.viewBetweenDates(startDate, endDate)) {
+            total += row.getProduction();
+            ++rows;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(rows));
+}
+BENCHMARK(BM_ViewBetweenDates)->ArgName("days")->Arg(1)->Arg(7)->Arg(30)->Arg(365);
+
+/// \brief Statystyki widoku (bez filtra i z filtrem wartoci) w oknie o podanej szerokoci (w dniach) z serii 10-letniej.
+/// \details Okna powyej RangeView::PARALLEL_MIN_ROWS wierszy s liczone rwnolegle we wsplnej puli wtkw.
+static void BM_ViewAggregate(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const TreeData& treeData = cachedTree(120);
+    int windowDays = static_cast<int>(state.range(0));
+    bool filtered = state.range(1) != 0;
+    string startDate, endDate;
+    size_t iteration = 0, rows = 0;
+    for (auto _ : state) {
+        queryWindow(iteration++, windowDays, startDate, endDate);
+        RangeView view = treeData.viewBetweenDates(startDate, endDate);
+        if (filtered) {
+            view = view.withValueBetween(Channel::Production, 0.5f, 3.0f);
+        }
+        Aggregate stats = view.aggregate();
+        benchmark::DoNotOptimize(stats);
+        rows += view.size();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(rows));
+    state.counters["threads"] = ThreadPool::shared().size();
+}
+BENCHMARK(BM_ViewAggregate)->ArgNames({ "days", "filtered" })->ArgsProduct({ { 30, 365, 3000 }, { 0, 1 } });
+
+/// \brief Sumy kanaw w oknie o podanej szerokoci (w dniach) z serii 10-letniej.
+static void BM_CalculateSums(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const TreeData& treeData = cachedTree(120);
+    int windowDays = static_cast<int>(state.range(0));
+    string startDate, endDate;
+    size_t iteration = 0;
+    float a, b, c, d, e;
+    for (auto _ : state) {
+        queryWindow(iteration++, windowDays, startDate, endDate);
+        treeData.calculateSumsBetweenDates(startDate, endDate, a, b, c, d, e);
+        benchmark::DoNotOptimize(a);
+    }
+}
+BENCHMARK(BM_CalculateSums)->ArgName("days")->Arg(1)->Arg(7)->Arg(30)->Arg(365)->Arg(3000);
+
+/// \brief rednie kanaw w oknie o podanej szerokoci (w dniach) z serii 10-letniej.
+static void BM_CalculateAverages(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const TreeData& treeData = cachedTree(120);
+    int windowDays = static_cast<int>(state.range(0));
+    string startDate, endDate;
+    size_t iteration = 0;
+    float a, b, c, d, e;
+    for (auto _ : state) {
+        queryWindow(iteration++, windowDays, startDate, endDate);
+        treeData.calculateAveragesBetweenDates(startDate, endDate, a, b, c, d, e);
+        benchmark::DoNotOptimize(a);
+    }
+}
+BENCHMARK(BM_CalculateAverages)->ArgName("days")->Arg(1)->Arg(7)->Arg(30)->Arg(365)->Arg(3000);
+
+/// \brief Statystyki zbiorcze (suma, minimum, maksimum) w oknie o podanej szerokoci z serii 10-letniej.
+static void BM_CalculateStats(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const TreeData& treeData = cachedTree(120);
+    int windowDays = static_cast<int>(state.range(0));
+    string startDate, endDate;
+    size_t iteration = 0;
+    for (auto _ : state) {
+        queryWindow(iteration++, windowDays, startDate, endDate);
+        Aggregate stats = treeData.calculateStatsBetweenDates(startDate, endDate);
+        benchmark::DoNotOptimize(stats.count);
+    }
+}
+BENCHMARK(BM_CalculateStats)->ArgName("days")->Arg(1)->Arg(7)->Arg(30)->Arg(365)->Arg(3000);
+
+/// \brief Szereg czasowy jednego roku w kubekach o podanej szerokoci (numer TreeData::Granularity).
+static void BM_Resample(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const TreeData& treeData = cachedTree(120);
+    auto granularity = static_cast<TreeData::Granularity>(state.range(0));
+    size_t buckets = 0;
+    for (auto _ : state) {
+        vector<TreeData::Bucket> series = treeData.resample("01.03.2005 00:00", "28.02.2006 23:59", granularity);
+        buckets += series.size();
+        benchmark::DoNotOptimize(series.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(buckets));
+}
+BENCHMARK(BM_Resample)->ArgName("granularity")->DenseRange(0, 5)->Unit(benchmark::kMicrosecond);
+
+/// \brief Zapis i odczyt wierszy pojedynczo (RowData::saveToBinary / RowData(ifstream&)) przez plik tymczasowy.
+static void BM_RowBinaryRoundTrip(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const vector<RowData>& rows = cachedRows(static_cast<int>(state.range(0)));
+    const string path = "benchmark_rows.bin";
+    for (auto _ : state) {
+        {
+            ofstream out(path, ios::binary | ios::trunc);
+            for (const auto& rowData : rows) {
+                rowData.saveToBinary(out);
+            }
+        }
+        ifstream in(path, ios::binary);
+        size_t loaded = 0;
+        while (in.peek() != EOF) {
+            RowData rowData(in);
+            ++loaded;
+        }
+        benchmark::DoNotOptimize(loaded);
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows.size()));
+}
+BENCHMARK(BM_RowBinaryRoundTrip)->ArgName("months")->Arg(12)->Arg(120)->Unit(benchmark::kMillisecond);
+
+/// \brief Zapis i odczyt migawki kolumnowej (TreeData::saveSnapshot / loadSnapshot).
+static void BM_SnapshotRoundTrip(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const TreeData& treeData = cachedTree(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        stringstream buffer(ios::in | ios::out | ios::binary);
+        treeData.saveSnapshot(buffer);
+        TreeData loaded;
+        loaded.loadSnapshot(buffer);
+        benchmark::DoNotOptimize(loaded.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * treeData.size()));
+}
+BENCHMARK(BM_SnapshotRoundTrip)->ArgName("months")->Arg(12)->Arg(120)->Arg(600)->Unit(benchmark::kMillisecond);
+
+/// \brief Otwarcie pliku indeksu odwzorowanego w pamici (zimny start bez wczytywania wierszy).
+static void BM_IndexOpen(benchmark::State& state) {
+    RssMeter rssMeter(state);
+    const string path = "benchmark_" + to_string(state.range(0)) + ".idx";
+    {
+        TreeData treeData;
+        treeData.addBatch(cachedRows(static_cast<int>(state.range(0))));
+        treeData.saveIndex(path);
+    }
+    for (auto _ : state) {
+        TreeData mapped;
+        mapped.openIndex(path);
+        benchmark::DoNotOptimize(mapped.size());
+    }
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_IndexOpen)->ArgName("months")->Arg(12)->Arg(120)->Arg(600)->Unit(benchmark::kMicrosecond);
+
+/// \brief Funkcja gwna - uruchamia testy wydajnoci.
+/// \details Jeli nie podano opcji --benchmark_out, wyniki s dodatkowo zapisywane w formacie JSON do pliku
+/// benchmark_results.json.
+int main(int argc, char** argv) {
+    globalLogger.startAsync();  ///< Logowanie jak w programie gwnym
+    errorLogger.startAsync();
+
+    vector<char*> arguments(argv, argv + argc);
+    bool hasOutput = false;
+    for (int i = 1; i < argc; ++i) {
+        hasOutput = hasOutput || strncmp(argv[i], "--benchmark_out=", 16) == 0;
+    }
+    char outputArgument[] = "--benchmark_out=benchmark_results.json";
+    char formatArgument[] = "--benchmark_out_format=json";
+    if (!hasOutput) {
+        arguments.push_back(outputArgument);
+        arguments.push_back(formatArgument);
+    }
+    int argumentCount = static_cast<int>(arguments.size());
+
+    benchmark::Initialize(&argumentCount, arguments.data());
+    if (benchmark::ReportUnrecognizedArguments(argumentCount, arguments.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
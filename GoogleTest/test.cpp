@@ -3,13 +3,42 @@
 /// \details Testy jednostkowe zostay zaimplementowane z uyciem frameworka GoogleTest.
 
 #include "pch.h"
+#include <cmath>
+#include "../P6/Timestamp.h"
+#include "../P6/Timestamp.cpp"
 #include "../P6/RowData.h"
 #include "../P6/RowData.cpp"
+#include "../P6/ColumnStore.h"
+#include "../P6/ColumnStore.cpp"
+#include "../P6/PrefixSumIndex.h"
+#include "../P6/PrefixSumIndex.cpp"
+#include "../P6/Aggregate.h"
+#include "../P6/Aggregate.cpp"
+#include "../P6/AggregateKernels.h"
+#include "../P6/AggregateKernels.cpp"
+#include "../P6/Snapshot.h"
+#include "../P6/Snapshot.cpp"
+#include "../P6/IndexFile.h"
+#include "../P6/IndexFile.cpp"
+#include "../P6/ThreadPool.h"
+#include "../P6/ThreadPool.cpp"
+#include "../P6/RangeView.h"
+#include "../P6/RangeView.cpp"
 #include "../P6/TreeData.h"
 #include "../P6/TreeData.cpp"
+#include "../P6/ConcurrentTreeData.h"
+#include "../P6/ConcurrentTreeData.cpp"
 #include "../P6/LogManager.h"
 #include "../P6/LogManager.cpp"
 #include "../P6/LineValidation.h"
+#include "../P6/MappedFile.h"
+#include "../P6/MappedFile.cpp"
+#include "../P6/CsvParser.h"
+#include "../P6/CsvParser.cpp"
+#include "../P6/CsvFollower.h"
+#include "../P6/CsvFollower.cpp"
+#include "../P6/MultiSiteData.h"
+#include "../P6/MultiSiteData.cpp"
 
 using namespace std;
 
@@ -19,7 +48,7 @@ TEST(RowDataTest, ConstructorFromString) {
     string line = "15.10.2023 12:00:00,100.5,200.5,300.5,400.5,500.5";
     RowData rd(line);
 
-    EXPECT_EQ(rd.getDate(), "15.10.2023 12:00:00");
+    EXPECT_EQ(rd.getDate(), "15.10.2023 12:00");
     EXPECT_FLOAT_EQ(rd.getConsumption(), 100.5);
     EXPECT_FLOAT_EQ(rd.getExport(), 200.5);
     EXPECT_FLOAT_EQ(rd.getImport(), 300.5);
@@ -41,7 +70,7 @@ TEST(RowDataTest, Serialization) {
     RowData rd2(in); ///< Deserializacja danych z pliku binarnego.
     in.close();
 
-    EXPECT_EQ(rd2.getDate(), "15.10.2023 12:00:00");
+    EXPECT_EQ(rd2.getDate(), "15.10.2023 12:00");
     EXPECT_FLOAT_EQ(rd2.getSelfConsumption(), 100.5);
     EXPECT_FLOAT_EQ(rd2.getExport(), 200.5);
     EXPECT_FLOAT_EQ(rd2.getImport(), 300.5);
@@ -49,6 +78,22 @@ TEST(RowDataTest, Serialization) {
     EXPECT_FLOAT_EQ(rd2.getProduction(), 500.5);
 }
 
+/// \brief Testuje parsowanie i formatowanie znacznikw czasu.
+/// \details Sprawdza format z jednocyfrow godzin z pliku CSV oraz pomijanie sekund.
+TEST(TimestampTest, ParseAndFormat) {
+    EXPECT_EQ(parseTimestamp("01.01.1970 00:00"), 0);
+    EXPECT_EQ(parseTimestamp("01.10.2020 0:15"), parseTimestamp("01.10.2020 00:00") + 15);
+    EXPECT_EQ(parseTimestamp("15.10.2023 12:00:59"), parseTimestamp("15.10.2023 12:00"));
+    EXPECT_EQ(parseTimestamp("01.03.2024 00:00") - parseTimestamp("28.02.2024 00:00"), 2 * 1440); ///< Rok przestpny.
+    EXPECT_EQ(formatTimestamp(parseTimestamp("01.10.2020 0:15")), "01.10.2020 00:15");
+    EXPECT_THROW(parseTimestamp("2023-10-15 12:00"), std::invalid_argument);
+    EXPECT_THROW(parseTimestamp("31.02.2023 10:00"), std::invalid_argument); ///< Dzie spoza miesica.
+    EXPECT_THROW(parseTimestamp("29.02.2023 10:00"), std::invalid_argument);
+    EXPECT_EQ(formatTimestamp(parseTimestamp("29.02.2000 10:00")), "29.02.2000 10:00");
+    EXPECT_THROW(parseTimestamp("01.01.9999 00:00"), std::invalid_argument); ///< Poza zakresem int32.
+    EXPECT_EQ(formatTimestamp(parseTimestamp("31.12.6000 23:59")), "31.12.6000 23:59");
+}
+
 /// \brief Testuje funkcj walidujc puste linie.
 /// \details Sprawdza, czy funkcja zwraca false dla pustej linii.
 TEST(LineValidationTest, EmptyLine) {
@@ -80,7 +125,7 @@ TEST(TreeDataTest, AddData) {
 
     vector<RowData> data = treeData.getDataBetweenDates("15.10.2023 00:00", "15.10.2023 23:59");
     ASSERT_EQ(data.size(), 1); ///< Sprawdzenie, czy dodany rekord jest w drzewie.
-    EXPECT_EQ(data[0].getDate(), "15.10.2023 12:00:00");
+    EXPECT_EQ(data[0].getDate(), "15.10.2023 12:00");
     EXPECT_FLOAT_EQ(data[0].getSelfConsumption(), 100.5);
     EXPECT_FLOAT_EQ(data[0].getExport(), 200.5);
     EXPECT_FLOAT_EQ(data[0].getImport(), 300.5);
@@ -108,3 +153,860 @@ TEST(TreeDataTest, CalculateSumsBetweenDates) {
     EXPECT_FLOAT_EQ(poborSum, 851.0); ///< Weryfikacja sum dla poboru.
     EXPECT_FLOAT_EQ(produkcjaSum, 1051.0); ///< Weryfikacja sum dla produkcji.
 }
+
+/// \brief Testuje magazyn kolumnowy dla wierszy dodanych poza kolejnoci.
+/// \details Sprawdza, czy wiersze zwracane z drzewa s posortowane wedug czasu.
+TEST(TreeDataTest, OutOfOrderRowsAreSorted) {
+    TreeData treeData;
+    treeData.addData(RowData("16.10.2023 08:00,3,3,3,3,3"));
+    treeData.addData(RowData("15.10.2023 12:00,1,1,1,1,1"));
+    treeData.addData(RowData("15.10.2023 18:00,2,2,2,2,2"));
+
+    vector<RowData> data = treeData.getDataBetweenDates("15.10.2023 00:00", "16.10.2023 23:59");
+    ASSERT_EQ(data.size(), 3);
+    EXPECT_EQ(data[0].getDate(), "15.10.2023 12:00");
+    EXPECT_EQ(data[1].getDate(), "15.10.2023 18:00");
+    EXPECT_EQ(data[2].getDate(), "16.10.2023 08:00");
+    EXPECT_FLOAT_EQ(data[2].getProduction(), 3.0f);
+}
+
+/// \brief Testuje granice przedziau czasowego w wyszukiwaniu binarnym.
+/// \details Sprawdza, czy obie daty graniczne s wczone do wyniku, a odwrcony przedzia jest pusty.
+TEST(TreeDataTest, RangeBoundsAreInclusive) {
+    TreeData treeData;
+    for (int minute = 0; minute < 60; minute += 15) {
+        treeData.addData(RowData("15.10.2023 10:" + to_string(minute / 10) + to_string(minute % 10) + ",1,1,1,1,1"));
+    }
+
+    EXPECT_EQ(treeData.getDataBetweenDates("15.10.2023 10:15", "15.10.2023 10:30").size(), 2);
+    EXPECT_EQ(treeData.getDataBetweenDates("15.10.2023 10:16", "15.10.2023 10:29").size(), 0);
+    EXPECT_EQ(treeData.getDataBetweenDates("15.10.2023 11:00", "15.10.2023 10:00").size(), 0);
+    EXPECT_EQ(treeData.getDataBetweenDates("01.01.2000 00:00", "01.01.2100 00:00").size(), 4);
+}
+
+/// \brief Testuje indeks sum prefiksowych po wstawieniu wiersza poza kolejnoci.
+/// \details Sprawdza, czy sumy i rednie pozostaj poprawne, gdy addData wstawia wiersz w rodek danych.
+TEST(TreeDataTest, PrefixSumsFollowOutOfOrderInserts) {
+    TreeData treeData;
+    treeData.addData(RowData("15.10.2023 10:00,1,2,3,4,5"));
+    treeData.addData(RowData("15.10.2023 12:00,10,20,30,40,50"));
+    treeData.addData(RowData("15.10.2023 11:00,100,200,300,400,500"));
+
+    float a, b, c, d, e;
+    treeData.calculateSumsBetweenDates("15.10.2023 11:00", "15.10.2023 12:00", a, b, c, d, e);
+    EXPECT_FLOAT_EQ(a, 110.0f);
+    EXPECT_FLOAT_EQ(e, 550.0f);
+
+    treeData.calculateAveragesBetweenDates("15.10.2023 00:00", "15.10.2023 23:59", a, b, c, d, e);
+    EXPECT_FLOAT_EQ(a, 37.0f);
+    EXPECT_FLOAT_EQ(c, 111.0f);
+}
+
+/// \brief Testuje statystyki zbiorcze liczone z wzw drzewa i brzegw przedziau.
+/// \details Porwnuje wynik z bezporednim przeliczeniem wierszy zwrconych przez getDataBetweenDates.
+TEST(TreeDataTest, StatsMatchRawRows) {
+    TreeData treeData;
+    for (int day = 1; day <= 60; ++day) {
+        for (int hour = 0; hour < 24; hour += 5) {
+            int32_t timestamp = makeTimestamp(2023, 1, 1, hour, 0) + (day - 1) * 1440;
+            float value = static_cast<float>((day * 37 + hour * 11) % 100);
+            treeData.addData(RowData(timestamp, value, value + 1, value + 2, value + 3, value + 4));
+        }
+    }
+
+    const string startDate = "03.01.2023 07:30", endDate = "17.02.2023 13:10";
+    Aggregate stats = treeData.calculateStatsBetweenDates(startDate, endDate);
+    vector<RowData> rows = treeData.getDataBetweenDates(startDate, endDate);
+
+    Aggregate expected;
+    for (const auto& rowData : rows) {
+        expected.add(rowData);
+    }
+    ASSERT_EQ(stats.count, expected.count);
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        EXPECT_DOUBLE_EQ(stats.sum[channel], expected.sum[channel]);
+        EXPECT_FLOAT_EQ(stats.min[channel], expected.min[channel]);
+        EXPECT_FLOAT_EQ(stats.max[channel], expected.max[channel]);
+    }
+
+    // Koniec przedziau w ostatniej minucie zakresu int32 obejmuje wszystkie dane
+    EXPECT_EQ(treeData.calculateStatsBetweenDates("01.01.2023 00:00", "23.01.6053 02:07").count, treeData.size());
+}
+
+/// \brief Testuje wektorowe funkcje liczce statystyki kolumn.
+/// \details Sprawdza kad implementacj obsugiwan przez procesor na zakresach o dugociach niepodzielnych
+/// przez szeroko wektora i porwnuje wynik z dodawaniem wierszy po kolei.
+TEST(AggregateKernelsTest, MatchRowByRowStats) {
+    ColumnStore store;
+    for (int i = 0; i < 1003; ++i) {
+        float value = static_cast<float>((i * 7919) % 1000) / 7.0f - 20.0f;
+        store.insert(RowData(i * 15, value, value * 2, -value, value + 0.5f, 3.0f));
+    }
+
+    const size_t first = 5, last = 998;
+    Aggregate expected;
+    for (size_t i = first; i < last; ++i) {
+        expected.add(store.rowAt(i));
+    }
+    for (int isa = 0; isa <= static_cast<int>(AggregateKernels::detectedIsa()); ++isa) {
+        Aggregate stats;
+        AggregateKernels::aggregate(store, first, last, stats, static_cast<AggregateKernels::Isa>(isa));
+        ASSERT_EQ(stats.count, expected.count);
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            EXPECT_NEAR(stats.sum[channel], expected.sum[channel], 1e-9 * (1 + fabs(expected.sum[channel])));
+            EXPECT_NEAR(stats.sumSquares[channel], expected.sumSquares[channel], 1e-9 * expected.sumSquares[channel]);
+            EXPECT_FLOAT_EQ(stats.min[channel], expected.min[channel]);
+            EXPECT_FLOAT_EQ(stats.max[channel], expected.max[channel]);
+        }
+    }
+    EXPECT_NEAR(expected.variance(Channel::Production), 0.0, 1e-9);
+}
+
+/// \brief Testuje porwnanie dwch przedziaw czasowych.
+/// \details Sprawdza rnice bezwzgldne i procentowe oraz brak wartoci procentowej przy zerowej sumie odniesienia.
+TEST(TreeDataTest, CompareRanges) {
+    TreeData treeData;
+    treeData.addData(RowData("15.10.2023 10:00,10,0,3,4,5"));
+    treeData.addData(RowData("15.10.2023 11:00,10,0,3,4,5"));
+    treeData.addData(RowData("16.10.2023 10:00,30,5,3,4,2"));
+
+    TreeData::RangeComparison comparison = treeData.compareRanges("15.10.2023 00:00", "15.10.2023 23:59",
+        "16.10.2023 00:00", "16.10.2023 23:59");
+    EXPECT_EQ(comparison.firstCount, 2u);
+    EXPECT_EQ(comparison.secondCount, 1u);
+    EXPECT_DOUBLE_EQ(comparison.absoluteDelta[static_cast<int>(Channel::SelfConsumption)], 10.0);
+    EXPECT_DOUBLE_EQ(comparison.percentDelta[static_cast<int>(Channel::SelfConsumption)], 50.0);
+    EXPECT_DOUBLE_EQ(comparison.percentDelta[static_cast<int>(Channel::Production)], -80.0);
+    EXPECT_TRUE(std::isnan(comparison.percentDelta[static_cast<int>(Channel::Export)]));
+
+    float a, b, c, d, e;
+    treeData.compareDataBetweenDates("15.10.2023 00:00", "15.10.2023 23:59", "16.10.2023 00:00", "16.10.2023 23:59", a, b, c, d, e);
+    EXPECT_FLOAT_EQ(a, 10.0f);
+    EXPECT_FLOAT_EQ(b, 5.0f);
+    EXPECT_FLOAT_EQ(c, -3.0f);
+}
+
+/// \brief Testuje wyszukiwanie z tolerancj.
+/// \details Porwnuje wynik z bezporednim przegldem wierszy dla jednego kanau i dla wszystkich kanaw.
+TEST(TreeDataTest, SearchRecordsWithTolerance) {
+    TreeData treeData;
+    for (int i = 0; i < 2000; ++i) {
+        float value = static_cast<float>((i * 13) % 500);
+        treeData.addData(RowData(makeTimestamp(2023, 5, 1, 0, 0) + i * 15, value, 0, value * 2, 0, 1000));
+    }
+
+    const string startDate = "02.05.2023 03:00", endDate = "18.05.2023 21:00";
+    vector<RowData> found = treeData.searchRecordsWithTolerance(startDate, endDate, 400.0f, 2.0f, Channel::Import);
+    size_t expected = 0;
+    for (const auto& rowData : treeData.getDataBetweenDates(startDate, endDate)) {
+        if (rowData.getImport() >= 398.0f && rowData.getImport() <= 402.0f) {
+            ASSERT_LT(expected, found.size());
+            EXPECT_EQ(found[expected].getTimestamp(), rowData.getTimestamp());
+            ++expected;
+        }
+    }
+    EXPECT_EQ(found.size(), expected);
+    EXPECT_GT(expected, 0u);
+
+    EXPECT_TRUE(treeData.searchRecordsWithTolerance(startDate, endDate, 700.0f, 5.0f, Channel::SelfConsumption).empty());
+    EXPECT_EQ(treeData.searchRecordsWithTolerance(startDate, endDate, 1000.0f, 0.0f).size(),
+        treeData.getDataBetweenDates(startDate, endDate).size());
+    EXPECT_THROW(treeData.searchRecordsWithTolerance(startDate, endDate, 1.0f, -1.0f), invalid_argument);
+
+    // Koniec przedziau w ostatniej minucie zakresu int32 nie zawa wyszukiwania
+    EXPECT_EQ(treeData.searchRecordsWithTolerance("01.05.2023 00:00", "23.01.6053 02:07", 1000.0f, 0.0f).size(),
+        treeData.size());
+}
+
+/// \brief Testuje zapis i odczyt migawki binarnej.
+/// \details Sprawdza, czy wczytane drzewo zwraca te same wiersze i sumy oraz czy uszkodzony plik jest odrzucany.
+TEST(TreeDataTest, SnapshotRoundTrip) {
+    TreeData treeData;
+    for (int i = 0; i < 300; ++i) {
+        float value = static_cast<float>(i % 17);
+        treeData.addData(RowData(makeTimestamp(2023, 3, 1, 0, 0) + i * 15, value, 1, 2, 3, value * 2));
+    }
+    stringstream snapshot(ios::in | ios::out | ios::binary);
+    treeData.saveSnapshot(snapshot);
+
+    TreeData loaded;
+    loaded.loadSnapshot(snapshot);
+    ASSERT_EQ(loaded.size(), treeData.size());
+    EXPECT_EQ(loaded.getDataBetweenDates("01.03.2023 10:00", "02.03.2023 10:00").size(),
+        treeData.getDataBetweenDates("01.03.2023 10:00", "02.03.2023 10:00").size());
+    float a1, b1, c1, d1, e1, a2, b2, c2, d2, e2;
+    treeData.calculateSumsBetweenDates("01.03.2023 05:00", "03.03.2023 20:00", a1, b1, c1, d1, e1);
+    loaded.calculateSumsBetweenDates("01.03.2023 05:00", "03.03.2023 20:00", a2, b2, c2, d2, e2);
+    EXPECT_FLOAT_EQ(a2, a1);
+    EXPECT_FLOAT_EQ(e2, e1);
+    EXPECT_EQ(loaded.calculateStatsBetweenDates("01.03.2023 05:00", "03.03.2023 20:00").count,
+        treeData.calculateStatsBetweenDates("01.03.2023 05:00", "03.03.2023 20:00").count);
+
+    string corrupted = snapshot.str();
+    corrupted[corrupted.size() / 2] ^= 0x5A;
+    stringstream corruptedStream(corrupted, ios::in | ios::binary);
+    EXPECT_THROW(loaded.loadSnapshot(corruptedStream), runtime_error);
+    EXPECT_EQ(loaded.size(), 0);
+}
+
+/// \brief Testuje plik indeksu odwzorowywany w pamici.
+/// \details Sprawdza, czy drzewo otwarte z indeksu zwraca te same wyniki zapyta, a dodanie wiersza
+/// kopiuje dane do pamici programu, nie zmieniajc pliku.
+TEST(TreeDataTest, MappedIndexMatchesInMemoryTree) {
+    TreeData treeData;
+    for (int i = 0; i < 3000; ++i) {
+        float value = static_cast<float>((i * 7) % 23);
+        treeData.addData(RowData(makeTimestamp(2023, 1, 30, 0, 0) + i * 15, value, value + 1, 2, 3, value * 2));
+    }
+    treeData.saveIndex("test.idx");
+
+    TreeData mapped;
+    ASSERT_TRUE(mapped.openIndex("test.idx"));
+    ASSERT_EQ(mapped.size(), treeData.size());
+
+    const string startDate = "31.01.2023 07:30", endDate = "25.02.2023 13:10";
+    EXPECT_EQ(mapped.getDataBetweenDates(startDate, endDate).size(), treeData.getDataBetweenDates(startDate, endDate).size());
+    Aggregate expected = treeData.calculateStatsBetweenDates(startDate, endDate);
+    Aggregate stats = mapped.calculateStatsBetweenDates(startDate, endDate);
+    ASSERT_EQ(stats.count, expected.count);
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        EXPECT_DOUBLE_EQ(stats.sum[channel], expected.sum[channel]);
+        EXPECT_FLOAT_EQ(stats.min[channel], expected.min[channel]);
+        EXPECT_FLOAT_EQ(stats.max[channel], expected.max[channel]);
+    }
+    float a1, b1, c1, d1, e1, a2, b2, c2, d2, e2;
+    treeData.calculateSumsBetweenDates(startDate, endDate, a1, b1, c1, d1, e1);
+    mapped.calculateSumsBetweenDates(startDate, endDate, a2, b2, c2, d2, e2);
+    EXPECT_FLOAT_EQ(a2, a1);
+    EXPECT_FLOAT_EQ(e2, e1);
+
+    mapped.addData(RowData("01.02.2023 00:05,1000,0,0,0,0"));
+    EXPECT_EQ(mapped.size(), treeData.size() + 1);
+    EXPECT_EQ(mapped.calculateStatsBetweenDates(startDate, endDate).count, expected.count + 1);
+
+    TreeData reopened;
+    ASSERT_TRUE(reopened.openIndex("test.idx"));
+    EXPECT_EQ(reopened.size(), treeData.size());
+
+    // Zapis pod ciek indeksu, z ktrego drzewo wanie czyta (Windows nie podmienia odwzorowanego pliku)
+    reopened.addData(RowData("01.02.2023 00:05,1000,0,0,0,0"));
+    reopened.saveIndex("test.idx");
+    TreeData resaved;
+    ASSERT_TRUE(resaved.openIndex("test.idx"));
+    EXPECT_EQ(resaved.size(), treeData.size() + 1);
+    EXPECT_EQ(resaved.calculateStatsBetweenDates(startDate, endDate).count, expected.count + 1);
+    resaved.saveIndex("test.idx");  ///< Bez modyfikacji - kolumny wci wypoyczone z zapisywanego pliku
+    ASSERT_TRUE(reopened.openIndex("test.idx"));
+    EXPECT_EQ(reopened.calculateStatsBetweenDates(startDate, endDate).count, expected.count + 1);
+
+    TreeData moved(std::move(reopened));  ///< Przeniesienie zachowuje wypoyczone kolumny
+    EXPECT_EQ(moved.calculateStatsBetweenDates(startDate, endDate).count, expected.count + 1);
+    ColumnStore owned;
+    owned.insert(RowData("01.02.2023 00:05,1,2,3,4,5"));
+    const int32_t* ownedTimestamps = owned.timestamps();
+    ColumnStore movedStore(std::move(owned));
+    EXPECT_EQ(movedStore.timestamps(), ownedTimestamps);  ///< Bez kopiowania kolumn
+    EXPECT_EQ(movedStore.size(), 1u);
+    EXPECT_TRUE(owned.empty());
+    EXPECT_FALSE(reopened.openIndex("missing.idx"));
+}
+
+/// \brief Testuje przydzielanie wzw kalendarza z zasobu pamici podanego w konstruktorze.
+/// \details Domylny zasb jest na czas wczytywania zastpiony zasobem, ktry zawsze zgasza wyjtek, wic
+/// kady wze musi trafi do areny drzewa. Kopia drzewa korzysta ju z domylnego zasobu.
+TEST(TreeDataTest, NodesUseProvidedMemoryResource) {
+    alignas(std::max_align_t) static char buffer[1 << 20];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    TreeData treeData(&arena);
+    EXPECT_EQ(treeData.resource(), &arena);
+
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    EXPECT_NO_THROW({
+        for (int i = 0; i < 3000; ++i) {
+            treeData.addData(RowData(makeTimestamp(2023, 11, 20, 0, 0) + i * 15, 1, 2, 3, 4, 5));
+        }
+    });
+    std::pmr::set_default_resource(previous);
+
+    EXPECT_EQ(treeData.calculateStatsBetweenDates("01.12.2023 00:00", "01.12.2023 23:59").count, 96u);
+    TreeData copy(treeData);
+    EXPECT_EQ(copy.resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(copy.calculateStatsBetweenDates("20.11.2023 00:00", "31.12.2023 23:59").count, 3000u);
+}
+
+/// \brief Testuje gsty kalendarz wzw na granicach dnia przestpnego i roku.
+/// \details Statystyki liczone z wzw musz by rwne sumom liczonym bezporednio z wierszy, take gdy dane
+/// maj luki i przedzia zaczyna si lub koczy w rodku dnia.
+TEST(TreeDataTest, DenseCalendarMatchesRows) {
+    TreeData treeData;
+    for (int i = 0; i < 400; ++i) {
+        int32_t timestamp = makeTimestamp(2024, 2, 27, 0, 0) + i * 15;
+        if (i % 97 < 30) continue;  ///< Luki w danych
+        treeData.addData(RowData(timestamp, static_cast<float>(i % 11), 0, 0, 0, 1));
+        treeData.addData(RowData(timestamp + 300 * 1440, static_cast<float>(i % 7), 0, 0, 0, 1));  ///< Przeom 2024/2025
+    }
+
+    const char* windows[][2] = {
+        { "28.02.2024 13:10", "01.03.2024 05:59" },
+        { "29.02.2024 00:00", "29.02.2024 23:59" },
+        { "01.01.2024 00:00", "31.12.2024 23:59" },
+        { "30.12.2024 18:00", "02.01.2025 07:45" },
+        { "01.01.2020 00:00", "01.01.2030 00:00" },
+    };
+    for (const auto& window : windows) {
+        Aggregate stats = treeData.calculateStatsBetweenDates(window[0], window[1]);
+        double expected = 0.0;
+        vector<RowData> rows = treeData.getDataBetweenDates(window[0], window[1]);
+        for (const auto& rowData : rows) {
+            expected += rowData.getSelfConsumption();
+        }
+        EXPECT_EQ(stats.count, rows.size()) << window[0];
+        EXPECT_DOUBLE_EQ(stats.sum[static_cast<int>(Channel::SelfConsumption)], expected) << window[0];
+    }
+}
+
+/// \brief Testuje szereg czasowy w kubekach dla wszystkich szerokoci kubeka.
+/// \details Kady kubeek musi mie te same statystyki, co zapytanie o jego (przycity do przedziau) zakres,
+/// a kubeki musz pokrywa przedzia bez przerw, take tam, gdzie brakuje danych.
+TEST(TreeDataTest, ResampleMatchesRangeStats) {
+    TreeData treeData;
+    for (int i = 0; i < 6000; ++i) {
+        if (i % 500 < 120) continue;  ///< Luki w danych
+        float value = static_cast<float>((i * 7) % 19);
+        treeData.addData(RowData(makeTimestamp(2023, 10, 20, 0, 0) + i * 15, value, 1, value * 3, 2, 5));
+    }
+
+    const string startDate = "23.10.2023 07:40", endDate = "15.12.2023 16:05";
+    const int32_t from = parseTimestamp(startDate), to = parseTimestamp(endDate) + 1;
+    for (int g = 0; g <= static_cast<int>(TreeData::Granularity::Month); ++g) {
+        vector<TreeData::Bucket> buckets = treeData.resample(startDate, endDate, static_cast<TreeData::Granularity>(g));
+        ASSERT_FALSE(buckets.empty());
+        EXPECT_LE(buckets.front().start, from);
+        EXPECT_GE(buckets.back().end, to);
+        size_t total = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            if (i > 0) {
+                EXPECT_EQ(buckets[i].start, buckets[i - 1].end);
+            }
+            Aggregate expected = treeData.calculateStatsBetweenDates(formatTimestamp(max(from, buckets[i].start)),
+                formatTimestamp(min(to, buckets[i].end) - 1));
+            ASSERT_EQ(buckets[i].stats.count, expected.count) << g << " " << formatTimestamp(buckets[i].start);
+            EXPECT_DOUBLE_EQ(buckets[i].stats.sum[static_cast<int>(Channel::Import)], expected.sum[static_cast<int>(Channel::Import)]);
+            EXPECT_FLOAT_EQ(buckets[i].stats.max[static_cast<int>(Channel::SelfConsumption)], expected.max[static_cast<int>(Channel::SelfConsumption)]);
+            total += buckets[i].stats.count;
+        }
+        EXPECT_EQ(total, treeData.getDataBetweenDates(startDate, endDate).size());
+    }
+
+    // Przedzia szerszy ni dane jest przycinany do pierwszego i ostatniego wiersza
+    vector<TreeData::Bucket> all = treeData.resample("01.01.1900 00:00", "01.01.2100 00:00", TreeData::Granularity::Minutes15);
+    EXPECT_EQ(all.size(), 5999u - 120u + 1u);
+    EXPECT_EQ(all.front().start, makeTimestamp(2023, 10, 20, 0, 0) + 120 * 15);
+    TreeData sparse;
+    sparse.addData(RowData("01.01.1990 00:00,1,1,1,1,1"));
+    sparse.addData(RowData("01.01.2030 00:00,1,1,1,1,1"));
+    EXPECT_THROW(sparse.resample("01.01.1900 00:00", "01.01.2100 00:00", TreeData::Granularity::Minutes15), std::invalid_argument);
+    EXPECT_EQ(sparse.resample("01.01.1900 00:00", "01.01.2100 00:00", TreeData::Granularity::Day).size(), 14611u);
+
+    vector<TreeData::Bucket> weeks = treeData.resample(startDate, endDate, TreeData::Granularity::Week);
+    EXPECT_EQ(formatTimestamp(weeks.front().start), "23.10.2023 00:00");  ///< Poniedziaek
+    vector<TreeData::Bucket> months = treeData.resample(startDate, endDate, TreeData::Granularity::Month);
+    ASSERT_EQ(months.size(), 3u);
+    EXPECT_EQ(formatTimestamp(months[1].start), "01.11.2023 00:00");
+    EXPECT_EQ(formatTimestamp(months[1].end), "01.12.2023 00:00");
+}
+
+/// \brief Testuje widoki na zakresy wierszy i ich filtry.
+/// \details Widok musi zwraca te same wiersze co getDataBetweenDates, a zoone filtry i odwiedzanie wynikw
+/// wyszukiwania - te same wiersze co odpowiednie funkcje zwracajce wektory.
+TEST(TreeDataTest, RangeViewsMatchCopiedResults) {
+    TreeData treeData;
+    for (int i = 0; i < 1500; ++i) {
+        float value = static_cast<float>((i * 11) % 37);
+        treeData.addData(RowData(makeTimestamp(2023, 6, 1, 0, 0) + i * 15, value, value / 2, 3, 4, 100 - value));
+    }
+    const string startDate = "03.06.2023 10:20", endDate = "12.06.2023 08:00";
+
+    RangeView view = treeData.viewBetweenDates(startDate, endDate);
+    vector<RowData> copied = treeData.getDataBetweenDates(startDate, endDate);
+    ASSERT_EQ(view.size(), copied.size());
+    size_t i = 0;
+    for (RangeView::Row row : view) {
+        EXPECT_EQ(row.getTimestamp(), copied[i].getTimestamp());
+        EXPECT_FLOAT_EQ(row.getProduction(), copied[i].getProduction());
+        ++i;
+    }
+    EXPECT_EQ(view.timestamps()[0], copied.front().getTimestamp());
+    EXPECT_EQ(view.aggregate().count, treeData.calculateStatsBetweenDates(startDate, endDate).count);
+
+    RangeView filtered = view.withValueBetween(Channel::SelfConsumption, 10.0f, 20.0f)
+        .filter([](const RangeView::Row& row) { return row.getProduction() > 85.0f; });
+    size_t expected = 0;
+    for (const auto& rowData : copied) {
+        expected += rowData.getSelfConsumption() >= 10.0f && rowData.getSelfConsumption() <= 20.0f && rowData.getProduction() > 85.0f;
+    }
+    EXPECT_EQ(filtered.count(), expected);
+    EXPECT_EQ(filtered.toVector().size(), expected);
+    EXPECT_EQ(filtered.aggregate().count, expected);
+    EXPECT_EQ(view.count(), copied.size());  ///< Filtry nie zmieniaj widoku rdowego
+
+    vector<RowData> found = treeData.searchRecordsWithTolerance(startDate, endDate, 12.0f, 1.0f, Channel::SelfConsumption);
+    vector<int32_t> visited;
+    treeData.forEachRecordWithTolerance(startDate, endDate, 12.0f, 1.0f, Channel::SelfConsumption,
+        [&visited](const RangeView::Row& row) { visited.push_back(row.getTimestamp()); });
+    ASSERT_EQ(visited.size(), found.size());
+    for (size_t j = 0; j < found.size(); ++j) {
+        EXPECT_EQ(visited[j], found[j].getTimestamp());
+    }
+    EXPECT_TRUE(treeData.viewBetweenDates(endDate, startDate).empty());
+}
+
+/// \brief Testuje pul wtkw z podkradaniem zada.
+/// \details Kade zadanie musi zosta wykonane dokadnie raz (take przy zadaniach o bardzo rnym czasie trwania),
+/// a wyjtek rzucony przez zadanie - przekazany wywoujcemu.
+TEST(ThreadPoolTest, RunsEveryTaskOnceAndRethrows) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+    const size_t taskCount = 1000;
+    vector<atomic<int>> runs(taskCount);
+    for (auto& counter : runs) {
+        counter.store(0);
+    }
+    pool.parallelFor(taskCount, [&runs](size_t taskIndex) {
+        if (taskIndex < 10) {
+            this_thread::sleep_for(chrono::milliseconds(5));  ///< Wolne zadania na pocztku pierwszego zakresu
+        }
+        ++runs[taskIndex];
+    });
+    for (size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex) {
+        EXPECT_EQ(runs[taskIndex].load(), 1) << "Zadanie " << taskIndex;
+    }
+
+    EXPECT_THROW(pool.parallelFor(100, [](size_t taskIndex) {
+        if (taskIndex == 42) throw runtime_error("Bd zadania");
+    }), runtime_error);
+
+    atomic<size_t> nested(0);
+    pool.parallelFor(8, [&pool, &nested](size_t) {
+        pool.parallelFor(4, [&nested](size_t) { ++nested; });  ///< Zagniedone wywoanie jest szeregowe
+    });
+    EXPECT_EQ(nested.load(), 32u);
+}
+
+/// \brief Testuje rwnolege statystyki duych widokw.
+/// \details Widok powyej progu PARALLEL_MIN_ROWS musi dawa ten sam wynik przy kadym wywoaniu i zgadza si
+/// ze statystykami liczonymi szeregowo wiersz po wierszu (sumy z dokadnoci do kolejnoci dodawania).
+TEST(RangeViewTest, ParallelAggregateIsDeterministic) {
+    const size_t rows = RangeView::PARALLEL_MIN_ROWS + 12345;
+    ColumnStore store;
+    store.resize(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        store.mutableTimestamps()[i] = static_cast<int32_t>(i * 15);
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            store.mutableColumn(static_cast<Channel>(channel))[i] = static_cast<float>((i * (channel + 3)) % 1001) / 7.0f;
+        }
+    }
+    RangeView view(store, 7, rows - 3);
+    RangeView filtered = view.withValueBetween(Channel::Export, 10.0f, 60.0f);
+
+    Aggregate serial, serialFiltered;
+    size_t expectedFiltered = 0;
+    for (size_t i = 7; i < rows - 3; ++i) {
+        serial.add(store.rowAt(i));
+        float value = store.valueAt(Channel::Export, i);
+        if (value >= 10.0f && value <= 60.0f) {
+            serialFiltered.add(store.rowAt(i));
+            ++expectedFiltered;
+        }
+    }
+
+    Aggregate first = view.aggregate(), second = view.aggregate();
+    EXPECT_EQ(first.count, serial.count);
+    EXPECT_EQ(filtered.count(), expectedFiltered);
+    EXPECT_EQ(filtered.aggregate().count, serialFiltered.count);
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        EXPECT_EQ(first.sum[channel], second.sum[channel]);  ///< Wynik powtarzalny co do bitu
+        EXPECT_NEAR(first.sum[channel], serial.sum[channel], 1e-9 * serial.sum[channel]);
+        EXPECT_FLOAT_EQ(first.min[channel], serial.min[channel]);
+        EXPECT_FLOAT_EQ(first.max[channel], serial.max[channel]);
+        EXPECT_NEAR(filtered.aggregate().sum[channel], serialFiltered.sum[channel], 1e-9 * serialFiltered.sum[channel]);
+    }
+}
+
+/// \brief Testuje hurtowe dodawanie paczek wierszy.
+/// \details Drzewo wypenione paczkami (uporzdkowan, nieuporzdkowan i nakadajc si na dane drzewa) musi
+/// zawiera te same wiersze, statystyki wzw i sumy co drzewo wypeniane wiersz po wierszu.
+TEST(TreeDataTest, AddBatchMatchesAddData) {
+    const int32_t start = makeTimestamp(2023, 12, 30, 0, 0);
+    vector<RowData> sorted, shuffled, overlapping;
+    for (int i = 0; i < 600; ++i) {
+        sorted.emplace_back(start + i * 15, static_cast<float>(i % 7), 1, 2, 3, static_cast<float>(i % 50));
+    }
+    for (int i = 0; i < 300; ++i) {
+        shuffled.emplace_back(start + 600 * 15 + ((i * 37) % 300) * 15, 1, 1, 1, 1, static_cast<float>(i));
+    }
+    for (int i = 0; i < 100; ++i) {
+        overlapping.emplace_back(start + 7 + i * 60, 2, 2, 2, 2, 2);  ///< Midzy istniejcymi wierszami
+    }
+
+    TreeData single, batched;
+    for (const auto* rows : { &sorted, &shuffled, &overlapping }) {
+        for (const auto& rowData : *rows) {
+            single.addData(rowData);
+        }
+    }
+    EXPECT_EQ(batched.addBatch(sorted), sorted.size());
+    EXPECT_EQ(batched.addBatch(shuffled), shuffled.size());
+    EXPECT_EQ(batched.addBatch(overlapping), overlapping.size());
+    ASSERT_EQ(batched.size(), single.size());
+
+    vector<RowData> expected = single.getDataBetweenDates("01.01.2000 00:00", "01.01.2030 00:00");
+    vector<RowData> actual = batched.getDataBetweenDates("01.01.2000 00:00", "01.01.2030 00:00");
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(actual[i].getTimestamp(), expected[i].getTimestamp()) << "Wiersz " << i;
+        EXPECT_FLOAT_EQ(actual[i].getProduction(), expected[i].getProduction());
+    }
+    for (const auto& window : { make_pair("30.12.2023 05:00", "31.12.2023 13:07"), make_pair("31.12.2023 23:00", "01.01.2024 12:00") }) {
+        Aggregate a = single.calculateStatsBetweenDates(window.first, window.second);
+        Aggregate b = batched.calculateStatsBetweenDates(window.first, window.second);
+        EXPECT_EQ(a.count, b.count);
+        EXPECT_NEAR(a.sum[static_cast<int>(Channel::Production)], b.sum[static_cast<int>(Channel::Production)], 1e-6);
+        EXPECT_FLOAT_EQ(a.max[static_cast<int>(Channel::SelfConsumption)], b.max[static_cast<int>(Channel::SelfConsumption)]);
+        float s1, s2, x;
+        single.calculateSumsBetweenDates(window.first, window.second, x, x, x, x, s1);
+        batched.calculateSumsBetweenDates(window.first, window.second, x, x, x, x, s2);
+        EXPECT_FLOAT_EQ(s1, s2);
+    }
+
+    vector<RowData> repeated = { overlapping[5], RowData(start - 15, 1, 1, 1, 1, 1), RowData(start - 15, 9, 9, 9, 9, 9) };
+    EXPECT_EQ(batched.addBatch(repeated, true), 1u);  ///< Tylko pierwszy wiersz o nowym znaczniku czasu
+    EXPECT_FLOAT_EQ(batched.getDataBetweenDates("29.12.2023 23:45", "29.12.2023 23:45").front().getProduction(), 1.0f);
+}
+
+/// \brief Testuje odczyty ConcurrentTreeData wspbiene z wczytywaniem.
+/// \details Czytelnicy sprawdzaj, czy kada pobrana wersja jest spjna (liczba wierszy zgadza si ze statystykami
+/// widoku i wzw kalendarza) oraz niezmienna, podczas gdy wtek piszcy dodaje i publikuje kolejne paczki wierszy.
+TEST(ConcurrentTreeDataTest, ReadersSeeConsistentSnapshots) {
+    const int batches = 40, batchSize = 96;
+    const int32_t start = makeTimestamp(2023, 1, 1, 0, 0);
+    ConcurrentTreeData treeData;
+    EXPECT_EQ(treeData.snapshot()->size(), 0u);
+
+    atomic<bool> done(false);
+    atomic<int> failures(0);
+    vector<thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            size_t previous = 0;
+            while (!done.load()) {
+                ConcurrentTreeData::Snapshot snapshot = treeData.snapshot();
+                size_t count = snapshot->size();
+                Aggregate stats = snapshot->viewBetweenDates("01.01.2023 00:00", "31.12.2023 23:45").aggregate();
+                Aggregate nodeStats = snapshot->calculateStatsBetweenDates("01.01.2023 00:00", "31.12.2023 23:45");
+                if (count < previous || count % batchSize != 0 || stats.count != count || nodeStats.count != count
+                    || stats.sum[static_cast<int>(Channel::Production)] != static_cast<double>(count)
+                    || snapshot->size() != count) {
+                    ++failures;
+                }
+                previous = count;
+            }
+        });
+    }
+
+    for (int b = 0; b < batches; ++b) {
+        for (int i = 0; i < batchSize; ++i) {
+            treeData.addData(RowData(start + (b * batchSize + i) * 15, 0, 0, 0, 0, 1));
+        }
+        EXPECT_EQ(treeData.pendingCount(), static_cast<size_t>(batchSize));
+        EXPECT_EQ(treeData.publish(), static_cast<size_t>(batchSize));
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(treeData.version(), static_cast<uint64_t>(batches));
+    EXPECT_EQ(treeData.publish(), 0u);
+    ConcurrentTreeData::Snapshot last = treeData.snapshot();
+    EXPECT_EQ(last->size(), static_cast<size_t>(batches * batchSize));
+    treeData.addData(RowData(start - 15, 0, 0, 0, 0, 1));
+    treeData.publish();
+    EXPECT_EQ(last->size(), static_cast<size_t>(batches * batchSize));  ///< Trzymana wersja si nie zmienia
+    EXPECT_EQ(treeData.snapshot()->size(), static_cast<size_t>(batches * batchSize + 1));
+}
+
+/// \brief Testuje publikacj w czasie, gdy wtek publikujcy trzyma star wersj.
+/// \details Wersja trzymana przez dwie kolejne publikacje nie moe ich wstrzyma, a po jej zwolnieniu obie
+/// kopie drzewa musz nadal zawiera kady wiersz dokadnie raz.
+TEST(ConcurrentTreeDataTest, HeldSnapshotDoesNotBlockPublish) {
+    ConcurrentTreeData treeData;
+    const int32_t start = makeTimestamp(2024, 5, 1, 0, 0);
+    auto publishRow = [&](int i) {
+        treeData.addData(RowData(start + i * 15, 1, 1, 1, 1, static_cast<float>(i)));
+        return treeData.publish();
+    };
+
+    publishRow(0);
+    ConcurrentTreeData::Snapshot held = treeData.snapshot();
+    EXPECT_EQ(publishRow(1), 1u);
+    EXPECT_EQ(publishRow(2), 1u);  ///< Kopia zapasowa jest trzymana - wersja powstaje z kopii
+    EXPECT_EQ(held->size(), 1u);
+    EXPECT_EQ(treeData.snapshot()->size(), 3u);
+
+    held.reset();
+    for (int i = 3; i < 6; ++i) {
+        publishRow(i);
+        ConcurrentTreeData::Snapshot current = treeData.snapshot();
+        ASSERT_EQ(current->size(), static_cast<size_t>(i + 1));
+        Aggregate stats = current->calculateStatsBetweenDates("01.05.2024 00:00", "02.05.2024 00:00");
+        EXPECT_DOUBLE_EQ(stats.sum[static_cast<int>(Channel::Production)], i * (i + 1) / 2.0);
+    }
+    EXPECT_EQ(treeData.version(), 6u);
+}
+
+/// \brief Testuje asynchroniczny tryb LogManager.
+/// \details Sprawdza, czy komunikaty z wielu wtkw trafiaj do pliku w caoci po zatrzymaniu wtku piszcego,
+/// a przy polityce Drop kady komunikat jest zapisany albo zliczony jako odrzucony.
+TEST(LogManagerTest, AsyncWriterFlushesAllMessages) {
+    const int threadCount = 4, perThread = 2000;
+    for (LogManager::OverflowPolicy policy : { LogManager::OverflowPolicy::Block, LogManager::OverflowPolicy::Drop }) {
+        LogManager logger("test_async");
+        logger.startAsync(16, policy);
+        vector<thread> producers;
+        for (int t = 0; t < threadCount; ++t) {
+            producers.emplace_back([&logger, t]() {
+                for (int i = 0; i < perThread; ++i) {
+                    logger.log("Watek " + to_string(t) + " komunikat " + to_string(i));
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        logger.stopAsync();
+
+        ifstream logFile(logger.getFileName());
+        int lines = 0;
+        for (string line; getline(logFile, line); ++lines) {
+            ASSERT_NE(line.find(" komunikat "), string::npos);
+        }
+        if (policy == LogManager::OverflowPolicy::Block) {
+            EXPECT_EQ(lines, threadCount * perThread);
+            EXPECT_EQ(logger.getDroppedCount(), 0u);
+        }
+        else {
+            EXPECT_EQ(lines + static_cast<int>(logger.getDroppedCount()), threadCount * perThread);
+        }
+    }
+}
+
+/// \brief Testuje poziomy logowania.
+/// \details Sprawdza, czy argumenty makr nie s obliczane poniej progu, a bdy s zawsze zliczane.
+TEST(LogManagerTest, LevelsSkipDisabledMessages) {
+    LogManager logger("test_levels");
+    int formatted = 0;
+    auto message = [&formatted](const string& text) { ++formatted; return text; };
+
+    logger.setLevel(LogLevel::Warn);
+    P6_LOG_INFO(logger, message("pominiety"));
+    P6_LOG_DEBUG(logger, message("pominiety"));
+    EXPECT_EQ(formatted, 0);
+    P6_LOG_WARN(logger, message("ostrzezenie"));
+    EXPECT_EQ(formatted, 1);
+    EXPECT_FALSE(logger.isEnabled(LogLevel::Info));
+    EXPECT_TRUE(logger.isEnabled(LogLevel::Error));
+
+    LogLevel previous = errorLogger.getLevel();
+    errorLogger.setLevel(LogLevel::Error);
+    int errorsBefore = errorLogCount;
+    P6_LOG_ERROR(errorLogger, message("blad"));
+    EXPECT_EQ(errorLogCount - errorsBefore, 1);
+    errorLogger.setLevel(previous);
+}
+
+/// \brief Testuje jednoprzebiegowy parser CSV.
+/// \details Sprawdza kategorie odrzuconych wierszy, usuwanie cudzysoww oraz wiersz przecinajcy granic bufora.
+TEST(CsvParserTest, ParsesStreamAndRejectsInvalidLines) {
+    int32_t timestamp;
+    float values[CHANNEL_COUNT];
+    const string header = "Time,Autokonsumpcja (W),Eksport (W),Import (W),Pobor (W),Produkcja (W)";
+    const string other = "15.10.2023 12:00,X,200.5,300.5,400.5,500.5";
+    const string fields = "15.10.2023 12:00,1,2,3";
+    EXPECT_EQ(CsvParser::parseLine(header.data(), header.data() + header.size(), timestamp, values), LineStatus::Header);
+    EXPECT_EQ(CsvParser::parseLine(other.data(), other.data() + other.size(), timestamp, values), LineStatus::OtherData);
+    EXPECT_EQ(CsvParser::parseLine(fields.data(), fields.data() + fields.size(), timestamp, values), LineStatus::WrongFieldCount);
+
+    istringstream in(header + "\r\n01.10.2020 0:15,\"0\",\"1.5\",\"406.8323\",\"406.8323\",\"0\"\r\n\n" + fields + "\n15.10.2023 12:00,1,2,3,4,5");
+    CsvParser parser(16);  ///< May bufor wymusza dzielenie wierszy midzy odczytami
+    vector<RowData> rows;
+    parser.parseStream(in, [&](const RowData& rd) { rows.push_back(rd); });
+
+    ASSERT_EQ(rows.size(), 2);
+    EXPECT_EQ(parser.getErrorCount(), 3);
+    EXPECT_EQ(rows[0].getDate(), "01.10.2020 00:15");
+    EXPECT_FLOAT_EQ(rows[0].getExport(), 1.5f);
+    EXPECT_FLOAT_EQ(rows[0].getImport(), 406.8323f);
+    EXPECT_FLOAT_EQ(rows[1].getProduction(), 5.0f);
+}
+
+/// \brief Testuje wczytywanie pliku CSV odwzorowanego w pamici.
+/// \details Sprawdza, czy plik jest parsowany w miejscu, a brakujcy plik jest zgaszany.
+TEST(CsvParserTest, ParsesMappedFile) {
+    ofstream out("test.csv", ios::binary);
+    out << "Time,Autokonsumpcja (W),Eksport (W),Import (W),Pobor (W),Produkcja (W)\n"
+        << "01.10.2020 0:00,\"0\",\"0\",\"406.8323\",\"406.8323\",\"0\"\n"
+        << "01.10.2020 0:15,\"1\",\"2\",\"3\",\"4\",\"5\"";
+    out.close();
+
+    MappedFile mappedFile;
+    ASSERT_TRUE(mappedFile.open("test.csv"));
+    EXPECT_GT(mappedFile.size(), 0u);
+    mappedFile.close();
+
+    CsvParser parser;
+    vector<RowData> rows;
+    ASSERT_TRUE(parser.parseFile("test.csv", [&](const RowData& rd) { rows.push_back(rd); }));
+    ASSERT_EQ(rows.size(), 2);
+    EXPECT_EQ(rows[1].getDate(), "01.10.2020 00:15");
+    EXPECT_FLOAT_EQ(rows[1].getProduction(), 5.0f);
+    EXPECT_FALSE(parser.parseFile("missing.csv", [&](const RowData& rd) { rows.push_back(rd); }));
+}
+
+/// \brief Testuje przyrostowe wczytywanie dopisywanego pliku CSV.
+/// \details Kolejne poll() musz wczytywa tylko nowe pene wiersze (niepeny wiersz czeka na dokoczenie),
+/// a po podmianie pliku wczytywa go od pocztku, przy czym TreeData::addDataUnique odrzuca powtrzenia.
+TEST(CsvParserTest, FollowerReadsOnlyAppendedLines) {
+    auto line = [](int minute, int value) {
+        return "01.10.2020 " + to_string(minute / 60) + ":" + (minute % 60 < 10 ? "0" : "") + to_string(minute % 60)
+            + ",\"1\",\"2\",\"3\",\"4\",\"" + to_string(value) + "\"\n";
+    };
+    {
+        ofstream out("follow.csv", ios::binary);
+        out << "Time,Autokonsumpcja (W),Eksport (W),Import (W),Pobor (W),Produkcja (W)\n" << line(0, 1) << line(15, 2);
+    }
+    TreeData treeData;
+    size_t added = 0;
+    auto addRow = [&](const RowData& rd) { added += treeData.addDataUnique(rd); };
+    CsvFollower follower("follow.csv");
+    ASSERT_TRUE(follower.poll(addRow));
+    EXPECT_EQ(follower.getPolledRowCount(), 2u);
+    EXPECT_EQ(follower.getLastTimestamp(), makeTimestamp(2020, 10, 1, 0, 15));
+    ASSERT_TRUE(follower.poll(addRow));
+    EXPECT_EQ(follower.getPolledRowCount(), 0u);
+
+    string partial = line(45, 4);
+    {
+        ofstream out("follow.csv", ios::binary | ios::app);
+        out << line(30, 3) << partial.substr(0, 10);  ///< Ostatni wiersz w trakcie zapisu
+    }
+    ASSERT_TRUE(follower.poll(addRow));
+    EXPECT_EQ(follower.getPolledRowCount(), 1u);
+    {
+        ofstream out("follow.csv", ios::binary | ios::app);
+        out << partial.substr(10);
+    }
+    ASSERT_TRUE(follower.poll(addRow));
+    EXPECT_EQ(follower.getPolledRowCount(), 1u);
+    EXPECT_EQ(treeData.size(), 4u);
+    EXPECT_FLOAT_EQ(treeData.calculateStatsBetweenDates("01.10.2020 00:00", "01.10.2020 01:00").sum[static_cast<int>(Channel::Production)], 10.0f);
+
+    {
+        ofstream out("follow.csv", ios::binary | ios::trunc);  ///< Podmiana pliku: stare wiersze i jeden nowy
+        out << line(30, 3) << line(45, 4) << line(60, 5);
+    }
+    ASSERT_TRUE(follower.poll(addRow));
+    EXPECT_EQ(follower.getRestartCount(), 1u);
+    EXPECT_EQ(follower.getPolledRowCount(), 3u);
+    EXPECT_EQ(added, 5u);  ///< Powtrzone wiersze nie zostay dodane
+    EXPECT_EQ(treeData.size(), 5u);
+    EXPECT_EQ(follower.getOffset(), 3 * line(0, 0).size());
+    EXPECT_FALSE(CsvFollower("missing.csv").poll(addRow));
+}
+
+/// \brief Testuje rwnolege parsowanie bufora.
+/// \details Sprawdza, czy kolejno wierszy i liczba bdw s takie same jak przy parsowaniu jednowtkowym.
+TEST(CsvParserTest, ParallelMatchesSerial) {
+    string content = "Time,Autokonsumpcja (W),Eksport (W),Import (W),Pobor (W),Produkcja (W)\n";
+    for (int i = 0; i < 500; ++i) {
+        content += formatTimestamp(makeTimestamp(2022, 1, 1, 0, 0) + i * 15) + "," + to_string(i) + ",1,2,3,4\n";
+        if (i % 97 == 0) {
+            content += "\n";  ///< Co jaki czas pusta linia
+        }
+    }
+
+    CsvParser serial, parallel;
+    vector<int32_t> serialRows, parallelRows;
+    serial.parseBuffer(content.data(), content.size(), [&](const RowData& rd) { serialRows.push_back(rd.getTimestamp()); });
+    int errorsBefore = errorLogCount;
+    parallel.parseBufferParallel(content.data(), content.size(), [&](const RowData& rd) { parallelRows.push_back(rd.getTimestamp()); }, 7);
+
+    EXPECT_EQ(parallelRows, serialRows);
+    EXPECT_EQ(parallel.getRowCount(), 500);
+    EXPECT_EQ(parallel.getErrorCount(), serial.getErrorCount());
+    EXPECT_EQ(errorLogCount - errorsBefore, static_cast<int>(serial.getErrorCount()));
+
+    CsvParser batched;
+    TreeData treeData;
+    size_t batches = 0;
+    batched.parseBufferBatches(content.data(), content.size(), [&](vector<RowData>& rows) {
+        ++batches;
+        treeData.addBatch(rows);
+    }, 7);
+    EXPECT_EQ(batches, 7u);
+    ASSERT_EQ(treeData.size(), 500u);
+    EXPECT_EQ(treeData.getDataBetweenDates("01.01.2000 00:00", "01.01.2100 00:00").back().getTimestamp(), serialRows.back());
+}
+
+/// \brief Testuje serie wielu instalacji na wsplnej osi czasu.
+/// \details Serie z przesunitymi i czciowo wsplnymi znacznikami czasu, dodane w dwch paczkach, musz
+/// zachowa swoje odczyty, a sumy zbiorcze - odpowiada sumom pojedynczych serii.
+TEST(MultiSiteDataTest, SharedTimelineTotals) {
+    const int32_t start = makeTimestamp(2023, 3, 1, 0, 0);
+    MultiSiteData sites;
+    MultiSiteData::SiteRows north{ "north", {} }, south{ "south", {} };
+    for (int i = 0; i < 100; ++i) {
+        north.rows.emplace_back(start + i * 15, 1, 0, 0, 0, static_cast<float>(i));
+    }
+    for (int i = 50; i < 150; i += 2) {
+        south.rows.emplace_back(start + i * 15, 2, 0, 0, 0, 10);
+    }
+    sites.addSeries({ north });
+    sites.addSeries({ south, MultiSiteData::SiteRows{ "north", { RowData(start - 15, 1, 0, 0, 0, 5) } } });
+
+    EXPECT_EQ(sites.siteCount(), 2u);
+    EXPECT_EQ(sites.timelineSize(), 126u);  ///< 100 + 25 nowych znacznikw poudnia + 1 wczeniejszy pnocy
+    EXPECT_EQ(sites.readingCount("north"), 101u);
+    EXPECT_EQ(sites.readingCount("south"), 50u);
+    vector<RowData> northRows = sites.getSiteDataBetweenDates("north", "01.03.2023 00:00", "01.03.2023 01:00");
+    ASSERT_EQ(northRows.size(), 5u);
+    EXPECT_FLOAT_EQ(northRows[4].getProduction(), 4.0f);  ///< Odczyt przeniesiony na now pozycj osi
+
+    const string startDate = "28.02.2023 00:00", endDate = "31.03.2023 00:00";
+    Aggregate all = sites.calculateStatsBetweenDates(MultiSiteData::SiteSet(), startDate, endDate);
+    EXPECT_EQ(all.count, 151u);
+    EXPECT_DOUBLE_EQ(all.sum[static_cast<int>(Channel::SelfConsumption)], 101.0 + 100.0);
+    EXPECT_DOUBLE_EQ(all.sum[static_cast<int>(Channel::Production)], 4950.0 + 5.0 + 500.0);
+    EXPECT_FLOAT_EQ(all.min[static_cast<int>(Channel::Production)], 0.0f);
+    EXPECT_FLOAT_EQ(all.max[static_cast<int>(Channel::Production)], 99.0f);
+
+    vector<RowData> totals = sites.totalsBetweenDates({ "north", "south" }, startDate, endDate);
+    ASSERT_EQ(totals.size(), 126u);
+    EXPECT_FLOAT_EQ(totals[51].getSelfConsumption(), 3.0f);  ///< 12:30 - odczyty obu instalacji
+    EXPECT_FLOAT_EQ(totals[51].getProduction(), 50.0f + 10.0f);
+    EXPECT_EQ(sites.totalsBetweenDates({ "south" }, startDate, endDate).size(), 50u);
+    EXPECT_THROW(sites.calculateStatsBetweenDates({ "east" }, startDate, endDate), invalid_argument);
+
+    // Powtrzona instalacja liczy si raz; przedzia zaczyna si i koczy w rodku sowa mapy obecnoci
+    const string from = "01.03.2023 03:10", to = "01.03.2023 20:20";
+    Aggregate twice = sites.calculateStatsBetweenDates({ "north", "north" }, from, to);
+    double expectedSum = 0.0;
+    vector<RowData> window = sites.getSiteDataBetweenDates("north", from, to);
+    for (const auto& rowData : window) {
+        expectedSum += rowData.getProduction();
+    }
+    EXPECT_EQ(twice.count, window.size());
+    EXPECT_DOUBLE_EQ(twice.sum[static_cast<int>(Channel::Production)], expectedSum);
+    EXPECT_THROW(sites.loadFiles({ { "east", "missing_site.csv" } }), runtime_error);
+    EXPECT_EQ(sites.siteCount(), 2u);
+}
@@ -0,0 +1,57 @@
+/// \file Aggregate.cpp
+/// \brief Implementacja struktury Aggregate - zbiorczych statystyk kanaw pomiarowych.
+
+#include "Aggregate.h"
+#include <algorithm>
+#include <limits>
+
+/// \brief Tworzy pust statystyk.
+/// \details Minima i maksima inicjalizowane s nieskoczonociami, aby pierwszy dodany wiersz je nadpisa.
+Aggregate::Aggregate() : count(0) {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        sum[channel] = 0.0;
+        sumSquares[channel] = 0.0;
+        min[channel] = std::numeric_limits<float>::infinity();
+        max[channel] = -std::numeric_limits<float>::infinity();
+    }
+}
+
+/// \brief Dodaje pojedynczy wiersz do statystyki.
+/// \param rowData Wiersz danych.
+void Aggregate::add(const RowData& rowData) {
+    ++count;
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        float value = rowData.getValue(static_cast<Channel>(channel));
+        sum[channel] += value;
+        sumSquares[channel] += static_cast<double>(value) * value;
+        min[channel] = std::min(min[channel], value);
+        max[channel] = std::max(max[channel], value);
+    }
+}
+
+/// \brief czy statystyk z inn statystyk.
+/// \param other Statystyka do doczenia.
+void Aggregate::merge(const Aggregate& other) {
+    count += other.count;
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        sum[channel] += other.sum[channel];
+        sumSquares[channel] += other.sumSquares[channel];
+        min[channel] = std::min(min[channel], other.min[channel]);
+        max[channel] = std::max(max[channel], other.max[channel]);
+    }
+}
+
+/// \brief Zwraca redni warto kanau.
+double Aggregate::average(Channel channel) const {
+    return count > 0 ? sum[static_cast<int>(channel)] / count : 0.0;
+}
+
+/// \brief Zwraca wariancj (populacyjn) wartoci kanau.
+/// \details Liczona jako E[x^2] - E[x]^2; drobne ujemne wyniki zaokrgle s obcinane do 0.
+double Aggregate::variance(Channel channel) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    double mean = average(channel);
+    return std::max(0.0, sumSquares[static_cast<int>(channel)] / count - mean * mean);
+}
@@ -0,0 +1,43 @@
+/// \file Aggregate.h
+/// \brief Deklaracja struktury Aggregate - zbiorczych statystyk kanaw pomiarowych.
+
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include <cstddef>
+#include "RowData.h" ///< Zaczenie pliku nagwkowego zawierajcego klas RowData.
+
+/// \struct Aggregate
+/// \brief Statystyki zbiorcze (liczba wierszy, sumy, sumy kwadratw, minima i maksima) dla wszystkich kanaw pomiarowych.
+/// Struktura ta jest przechowywana w wzach drzewa jako biece podsumowanie danych, a take zwracana
+/// jako wynik zapyta o statystyki w przedziale czasowym.
+struct Aggregate {
+    size_t count; ///< Liczba wierszy objtych statystyk.
+    double sum[CHANNEL_COUNT]; ///< Sumy kanaw w podwjnej precyzji.
+    double sumSquares[CHANNEL_COUNT]; ///< Sumy kwadratw wartoci kanaw (do wariancji).
+    float min[CHANNEL_COUNT]; ///< Minimalne wartoci kanaw.
+    float max[CHANNEL_COUNT]; ///< Maksymalne wartoci kanaw.
+
+    /// \brief Tworzy pust statystyk (count = 0).
+    Aggregate();
+
+    /// \brief Dodaje pojedynczy wiersz do statystyki.
+    /// \param rowData Wiersz danych.
+    void add(const RowData& rowData);
+
+    /// \brief czy statystyk z inn statystyk.
+    /// \param other Statystyka do doczenia.
+    void merge(const Aggregate& other);
+
+    /// \brief Zwraca redni warto kanau.
+    /// \param channel Kana pomiarowy.
+    /// \return rednia lub 0, jeli statystyka jest pusta.
+    double average(Channel channel) const;
+
+    /// \brief Zwraca wariancj (populacyjn) wartoci kanau.
+    /// \param channel Kana pomiarowy.
+    /// \return Wariancja lub 0, jeli statystyka jest pusta.
+    double variance(Channel channel) const;
+};
+
+#endif // AGGREGATE_H
@@ -0,0 +1,182 @@
+/// \file AggregateKernels.cpp
+/// \brief Implementacja wektorowych (SIMD) funkcji liczcych statystyki kolumn.
+
+#include "AggregateKernels.h"
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define P6_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC i Clang wymagaj oznaczenia funkcji uywajcych instrukcji spoza bazowego zestawu kompilacji.
+// MSVC pozwala na uycie funkcji wewntrznych AVX2 bez dodatkowych opcji.
+#if defined(__GNUC__) || defined(__clang__)
+#define P6_TARGET_SSE2 __attribute__((target("sse2")))
+#define P6_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define P6_TARGET_SSE2
+#define P6_TARGET_AVX2
+#endif
+
+/// \struct ChannelTotals
+/// \brief Wyniki przebiegu po jednej kolumnie.
+struct ChannelTotals {
+    double sum; ///< Suma wartoci.
+    double sumSquares; ///< Suma kwadratw wartoci.
+    float min; ///< Minimalna warto.
+    float max; ///< Maksymalna warto.
+};
+
+static const size_t MIN_VECTOR_ROWS = 64; ///< Poniej tej liczby wierszy przygotowanie rejestrw kosztuje wicej ni sam przebieg.
+
+/// \brief Przeglda kolumn zwyk ptl (take kocwki kolumn w wersjach wektorowych).
+static void scanScalar(const float* values, size_t count, ChannelTotals& totals) {
+    for (size_t i = 0; i < count; ++i) {
+        double value = values[i];
+        totals.sum += value;
+        totals.sumSquares += value * value;
+        totals.min = std::min(totals.min, values[i]);
+        totals.max = std::max(totals.max, values[i]);
+    }
+}
+
+#ifdef P6_KERNELS_X86
+
+/// \brief Przeglda kolumn instrukcjami SSE2, po 4 wartoci naraz (sumy w dwch rejestrach podwjnej precyzji).
+P6_TARGET_SSE2 static void scanSse2(const float* values, size_t count, ChannelTotals& totals) {
+    __m128d sumLow = _mm_setzero_pd(), sumHigh = _mm_setzero_pd();
+    __m128d squaresLow = _mm_setzero_pd(), squaresHigh = _mm_setzero_pd();
+    __m128 minimum = _mm_set1_ps(totals.min), maximum = _mm_set1_ps(totals.max);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 block = _mm_loadu_ps(values + i);
+        minimum = _mm_min_ps(minimum, block);
+        maximum = _mm_max_ps(maximum, block);
+        __m128d low = _mm_cvtps_pd(block);
+        __m128d high = _mm_cvtps_pd(_mm_movehl_ps(block, block));
+        sumLow = _mm_add_pd(sumLow, low);
+        sumHigh = _mm_add_pd(sumHigh, high);
+        squaresLow = _mm_add_pd(squaresLow, _mm_mul_pd(low, low));
+        squaresHigh = _mm_add_pd(squaresHigh, _mm_mul_pd(high, high));
+    }
+
+    double sums[2], squares[2];
+    float minimums[4], maximums[4];
+    _mm_storeu_pd(sums, _mm_add_pd(sumLow, sumHigh));
+    _mm_storeu_pd(squares, _mm_add_pd(squaresLow, squaresHigh));
+    _mm_storeu_ps(minimums, minimum);
+    _mm_storeu_ps(maximums, maximum);
+    totals.sum += sums[0] + sums[1];
+    totals.sumSquares += squares[0] + squares[1];
+    totals.min = *std::min_element(minimums, minimums + 4);
+    totals.max = *std::max_element(maximums, maximums + 4);
+    scanScalar(values + i, count - i, totals);
+}
+
+/// \brief Przeglda kolumn instrukcjami AVX2 i FMA, po 8 wartoci naraz (sumy w dwch rejestrach podwjnej precyzji).
+P6_TARGET_AVX2 static void scanAvx2(const float* values, size_t count, ChannelTotals& totals) {
+    __m256d sumLow = _mm256_setzero_pd(), sumHigh = _mm256_setzero_pd();
+    __m256d squaresLow = _mm256_setzero_pd(), squaresHigh = _mm256_setzero_pd();
+    __m256 minimum = _mm256_set1_ps(totals.min), maximum = _mm256_set1_ps(totals.max);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 block = _mm256_loadu_ps(values + i);
+        minimum = _mm256_min_ps(minimum, block);
+        maximum = _mm256_max_ps(maximum, block);
+        __m256d low = _mm256_cvtps_pd(_mm256_castps256_ps128(block));
+        __m256d high = _mm256_cvtps_pd(_mm256_extractf128_ps(block, 1));
+        sumLow = _mm256_add_pd(sumLow, low);
+        sumHigh = _mm256_add_pd(sumHigh, high);
+        squaresLow = _mm256_fmadd_pd(low, low, squaresLow);
+        squaresHigh = _mm256_fmadd_pd(high, high, squaresHigh);
+    }
+
+    double sums[4], squares[4];
+    float minimums[8], maximums[8];
+    _mm256_storeu_pd(sums, _mm256_add_pd(sumLow, sumHigh));
+    _mm256_storeu_pd(squares, _mm256_add_pd(squaresLow, squaresHigh));
+    _mm256_storeu_ps(minimums, minimum);
+    _mm256_storeu_ps(maximums, maximum);
+    totals.sum += (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    totals.sumSquares += (squares[0] + squares[1]) + (squares[2] + squares[3]);
+    totals.min = *std::min_element(minimums, minimums + 8);
+    totals.max = *std::max_element(maximums, maximums + 8);
+    scanScalar(values + i, count - i, totals);
+}
+
+#endif // P6_KERNELS_X86
+
+/// \brief Zwraca najlepszy zestaw instrukcji obsugiwany przez biecy procesor.
+/// \details AVX2 wymaga te FMA oraz wczonej przez system obsugi rejestrw YMM (OSXSAVE/XGETBV).
+AggregateKernels::Isa AggregateKernels::detectedIsa() {
+    static const Isa isa = []() {
+#if defined(P6_KERNELS_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return Isa::Sse2;
+        }
+        __cpuid(info, 1);
+        bool fma = (info[2] & (1 << 12)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!fma || !osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return Isa::Sse2;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0 ? Isa::Avx2 : Isa::Sse2;
+#elif defined(P6_KERNELS_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return Isa::Avx2;
+        }
+        return __builtin_cpu_supports("sse2") ? Isa::Sse2 : Isa::Scalar;
+#else
+        return Isa::Scalar;
+#endif
+    }();
+    return isa;
+}
+
+/// \brief Dodaje do statystyki wiersze magazynu z pozycji [first, last).
+void AggregateKernels::aggregate(const ColumnStore& store, size_t first, size_t last, Aggregate& result) {
+    aggregate(store, first, last, result, detectedIsa());
+}
+
+/// \brief Dodaje do statystyki wiersze magazynu z pozycji [first, last), uywajc wskazanej implementacji.
+/// \details Kada kolumna jest przegldana osobno, sekwencyjnie po pamici, wic koszt ogranicza przepustowo pamici.
+void AggregateKernels::aggregate(const ColumnStore& store, size_t first, size_t last, Aggregate& result, Isa isa) {
+    if (last <= first) {
+        return;
+    }
+    size_t count = last - first;
+    if (count < MIN_VECTOR_ROWS) {
+        isa = Isa::Scalar;  ///< Krtkie przedziay (brzegi zapyta, drobne kubeki) - ptla skalarna jest szybsza
+    }
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        const float* values = store.column(static_cast<Channel>(channel)) + first;
+        ChannelTotals totals = { 0.0, 0.0, result.min[channel], result.max[channel] };
+        switch (isa) {
+#ifdef P6_KERNELS_X86
+        case Isa::Avx2:
+            scanAvx2(values, count, totals);
+            break;
+        case Isa::Sse2:
+            scanSse2(values, count, totals);
+            break;
+#endif
+        default:
+            scanScalar(values, count, totals);
+            break;
+        }
+        result.sum[channel] += totals.sum;
+        result.sumSquares[channel] += totals.sumSquares;
+        result.min[channel] = totals.min;
+        result.max[channel] = totals.max;
+    }
+    result.count += count;
+}
@@ -0,0 +1,43 @@
+/// \file AggregateKernels.h
+/// \brief Deklaracja klasy AggregateKernels - wektorowych (SIMD) funkcji liczcych statystyki kolumn.
+
+#ifndef AGGREGATEKERNELS_H
+#define AGGREGATEKERNELS_H
+
+#include <cstddef>
+#include "ColumnStore.h" ///< Kolumnowy magazyn wierszy, ktrego kolumny s przegldane.
+#include "Aggregate.h" ///< Statystyki zbiorcze bdce wynikiem oblicze.
+
+/// \class AggregateKernels
+/// \brief Liczy liczb wierszy, sum, sum kwadratw, minimum i maksimum kolumn jednym przebiegiem po pamici.
+/// Dostpne s trzy implementacje: AVX2 (8 wartoci naraz), SSE2 (4 wartoci naraz) i skalarna. Najlepsza
+/// obsugiwana przez procesor jest wybierana w czasie dziaania programu. Sumy liczone s w podwjnej precyzji,
+/// wic wynik nie traci dokadnoci nawet dla wieloletnich przedziaw.
+class AggregateKernels {
+public:
+    /// \enum Isa
+    /// \brief Zestaw instrukcji uywany przez funkcje obliczeniowe.
+    enum class Isa {
+        Scalar, ///< Zwyka ptla, dostpna na kadym procesorze.
+        Sse2, ///< Instrukcje SSE2 (x86).
+        Avx2 ///< Instrukcje AVX2 (x86).
+    };
+
+    /// \brief Zwraca najlepszy zestaw instrukcji obsugiwany przez biecy procesor.
+    /// \details Wynik jest ustalany jednokrotnie, przy pierwszym wywoaniu.
+    static Isa detectedIsa();
+
+    /// \brief Dodaje do statystyki wiersze magazynu z pozycji [first, last).
+    /// \param store Magazyn kolumnowy.
+    /// \param first Pozycja pierwszego wiersza.
+    /// \param last Pozycja za ostatnim wierszem.
+    /// \param[in,out] result Statystyka, do ktrej dodawane s wiersze.
+    static void aggregate(const ColumnStore& store, size_t first, size_t last, Aggregate& result);
+
+    /// \brief Dodaje do statystyki wiersze magazynu z pozycji [first, last), uywajc wskazanej implementacji.
+    /// \param isa Zestaw instrukcji; musi by obsugiwany przez procesor (nie wyszy ni detectedIsa()).
+    /// \details Suy gwnie do porwnywania implementacji w testach.
+    static void aggregate(const ColumnStore& store, size_t first, size_t last, Aggregate& result, Isa isa);
+};
+
+#endif // AGGREGATEKERNELS_H
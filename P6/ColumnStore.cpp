@@ -0,0 +1,214 @@
+/// \file ColumnStore.cpp
+/// \brief Implementacja kolumnowego magazynu wierszy danych.
+
+#include "ColumnStore.h"
+#include <algorithm>
+
+/// \brief Tworzy pusty magazyn.
+ColumnStore::ColumnStore() {
+    bindOwned();
+}
+
+/// \brief Kopiuje magazyn; wypoyczone kolumny pozostaj wspdzielone z oryginaem.
+ColumnStore::ColumnStore(const ColumnStore& other)
+    : timestampColumn(other.timestampColumn), owner(other.owner) {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        valueColumns[channel] = other.valueColumns[channel];
+    }
+    if (owner) {
+        timestampData = other.timestampData;
+        std::copy(other.valueData, other.valueData + CHANNEL_COUNT, valueData);
+        count = other.count;
+    }
+    else {
+        bindOwned();
+    }
+}
+
+/// \brief Przypisuje zawarto innego magazynu.
+ColumnStore& ColumnStore::operator=(const ColumnStore& other) {
+    if (this != &other) {
+        ColumnStore copy(other);
+        timestampColumn.swap(copy.timestampColumn);
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            valueColumns[channel].swap(copy.valueColumns[channel]);
+        }
+        owner = copy.owner;
+        if (owner) {
+            timestampData = copy.timestampData;
+            std::copy(copy.valueData, copy.valueData + CHANNEL_COUNT, valueData);
+            count = copy.count;
+        }
+        else {
+            bindOwned();
+        }
+    }
+    return *this;
+}
+
+/// \brief Przenosi kolumny innego magazynu bez kopiowania.
+/// \details Przeniesienie wektora nie zmienia adresu jego danych, wic wskaniki odczytu wasnych kolumn
+/// s po prostu ustawiane ponownie.
+ColumnStore::ColumnStore(ColumnStore&& other) noexcept
+    : timestampColumn(std::move(other.timestampColumn)), owner(std::move(other.owner)) {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        valueColumns[channel] = std::move(other.valueColumns[channel]);
+    }
+    if (owner) {
+        timestampData = other.timestampData;
+        std::copy(other.valueData, other.valueData + CHANNEL_COUNT, valueData);
+        count = other.count;
+    }
+    else {
+        bindOwned();
+    }
+    other.clear();
+}
+
+/// \brief Przenosi kolumny innego magazynu bez kopiowania.
+ColumnStore& ColumnStore::operator=(ColumnStore&& other) noexcept {
+    if (this != &other) {
+        timestampColumn = std::move(other.timestampColumn);
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            valueColumns[channel] = std::move(other.valueColumns[channel]);
+        }
+        owner = std::move(other.owner);
+        if (owner) {
+            timestampData = other.timestampData;
+            std::copy(other.valueData, other.valueData + CHANNEL_COUNT, valueData);
+            count = other.count;
+        }
+        else {
+            bindOwned();
+        }
+        other.clear();
+    }
+    return *this;
+}
+
+/// \brief Podcza kolumny z zewntrznej pamici bez kopiowania.
+/// \details Wasne wektory s zwalniane, a odczyt odbywa si bezporednio z podanej pamici.
+void ColumnStore::attach(const int32_t* timestamps, const float* const values[CHANNEL_COUNT], size_t rowCount,
+    std::shared_ptr<const void> memoryOwner) {
+    std::vector<int32_t>().swap(timestampColumn);
+    for (auto& column : valueColumns) {
+        std::vector<float>().swap(column);
+    }
+    timestampData = timestamps;
+    std::copy(values, values + CHANNEL_COUNT, valueData);
+    count = rowCount;
+    owner = std::move(memoryOwner);
+}
+
+/// \brief Wstawia wiersz z zachowaniem porzdku czasowego.
+/// \param rowData Wiersz danych do wstawienia.
+/// \return Pozycja, na ktrej wiersz zosta zapisany.
+/// \details Dane z eksportw CSV przychodz chronologicznie, wic typowy przypadek to dopisanie na koniec kolumn.
+/// Dla wiersza spoza kolejnoci pozycja jest wyszukiwana binarnie, a kolumny s przesuwane.
+size_t ColumnStore::insert(const RowData& rowData) {
+    detach();
+    int32_t timestamp = rowData.getTimestamp();
+    size_t index = timestampColumn.size();
+
+    if (!timestampColumn.empty() && timestamp < timestampColumn.back()) {
+        index = upperBound(timestamp);
+    }
+
+    timestampColumn.insert(timestampColumn.begin() + index, timestamp);
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        std::vector<float>& values = valueColumns[channel];
+        values.insert(values.begin() + index, rowData.getValue(static_cast<Channel>(channel)));
+    }
+    bindOwned();
+    return index;
+}
+
+/// \brief Rezerwuje miejsce na podan liczb wierszy we wszystkich kolumnach.
+void ColumnStore::reserve(size_t rowCount) {
+    detach();
+    timestampColumn.reserve(rowCount);
+    for (auto& values : valueColumns) {
+        values.reserve(rowCount);
+    }
+    bindOwned();
+}
+
+/// \brief Usuwa wszystkie wiersze z magazynu.
+void ColumnStore::clear() {
+    owner.reset();  ///< Wypoyczonych kolumn nie trzeba kopiowa
+    timestampColumn.clear();
+    for (auto& values : valueColumns) {
+        values.clear();
+    }
+    bindOwned();
+}
+
+/// \brief Ustawia liczb wierszy we wszystkich kolumnach.
+void ColumnStore::resize(size_t rowCount) {
+    detach();
+    timestampColumn.resize(rowCount);
+    for (auto& values : valueColumns) {
+        values.resize(rowCount);
+    }
+    bindOwned();
+}
+
+/// \brief Zwraca modyfikowalny wskanik na kolumn znacznikw czasu.
+int32_t* ColumnStore::mutableTimestamps() {
+    detach();
+    return timestampColumn.data();
+}
+
+/// \brief Zwraca modyfikowalny wskanik na kolumn wskazanego kanau.
+float* ColumnStore::mutableColumn(Channel channel) {
+    detach();
+    return valueColumns[static_cast<int>(channel)].data();
+}
+
+/// \brief Sprawdza, czy kolumna znacznikw czasu jest posortowana rosnco.
+bool ColumnStore::isSorted() const {
+    return std::is_sorted(timestampData, timestampData + count);
+}
+
+/// \brief Wyszukuje binarnie pierwszy wiersz o czasie nie wczeniejszym ni podany.
+size_t ColumnStore::lowerBound(int32_t timestamp) const {
+    return std::lower_bound(timestampData, timestampData + count, timestamp) - timestampData;
+}
+
+/// \brief Wyszukuje binarnie pierwszy wiersz o czasie pniejszym ni podany.
+size_t ColumnStore::upperBound(int32_t timestamp) const {
+    return std::upper_bound(timestampData, timestampData + count, timestamp) - timestampData;
+}
+
+/// \brief Odtwarza obiekt RowData z wiersza na podanej pozycji.
+RowData ColumnStore::rowAt(size_t index) const {
+    return RowData(timestampData[index],
+        valueData[static_cast<int>(Channel::SelfConsumption)][index],
+        valueData[static_cast<int>(Channel::Export)][index],
+        valueData[static_cast<int>(Channel::Import)][index],
+        valueData[static_cast<int>(Channel::Consumption)][index],
+        valueData[static_cast<int>(Channel::Production)][index]);
+}
+
+/// \brief Kopiuje wypoyczone kolumny do wasnych wektorw.
+/// \details Wywoywana przed kad modyfikacj; dla wasnych kolumn nic nie robi.
+void ColumnStore::detach() {
+    if (!owner) {
+        return;
+    }
+    timestampColumn.assign(timestampData, timestampData + count);
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        valueColumns[channel].assign(valueData[channel], valueData[channel] + count);
+    }
+    owner.reset();
+    bindOwned();
+}
+
+/// \brief Ustawia wskaniki odczytu na wasne wektory.
+void ColumnStore::bindOwned() {
+    timestampData = timestampColumn.data();
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        valueData[channel] = valueColumns[channel].data();
+    }
+    count = timestampColumn.size();
+}
@@ -0,0 +1,128 @@
+/// \file ColumnStore.h
+/// \brief Deklaracja klasy ColumnStore - kolumnowego magazynu wierszy danych posortowanych wedug czasu.
+
+#ifndef COLUMNSTORE_H
+#define COLUMNSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "RowData.h" ///< Zaczenie pliku nagwkowego zawierajcego klas RowData.
+
+/// \class ColumnStore
+/// \brief Przechowuje wiersze danych w ukadzie kolumnowym (struktura tablic).
+/// Znaczniki czasu oraz kady z piciu kanaw pomiarowych s zapisane w osobnych, cigych wektorach,
+/// posortowanych rosnco wedug czasu. Jeden wiersz zajmuje 24 bajty (4 bajty czasu i 5 wartoci float),
+/// a przegldanie zakresu danych odbywa si sekwencyjnie po pamici.
+/// Kolumny mog te by wypoyczone z zewntrznej pamici tylko do odczytu (np. pliku indeksu odwzorowanego
+/// w pamici, zob. attach()). Pierwsza modyfikacja takiego magazynu kopiuje kolumny do wasnych wektorw.
+class ColumnStore {
+public:
+    /// \brief Tworzy pusty magazyn.
+    ColumnStore();
+
+    /// \brief Kopiuje magazyn; wypoyczone kolumny pozostaj wspdzielone z oryginaem (bez kopiowania danych).
+    ColumnStore(const ColumnStore& other);
+
+    /// \brief Przypisuje kopi innego magazynu.
+    ColumnStore& operator=(const ColumnStore& other);
+
+    /// \brief Przenosi kolumny innego magazynu bez kopiowania; wypoyczona pami pozostaje wspdzielona.
+    /// \details Magazyn rdowy zostaje pusty.
+    ColumnStore(ColumnStore&& other) noexcept;
+
+    /// \brief Przenosi kolumny innego magazynu bez kopiowania (magazyn rdowy zostaje pusty).
+    ColumnStore& operator=(ColumnStore&& other) noexcept;
+
+    /// \brief Podcza kolumny z zewntrznej pamici bez kopiowania.
+    /// \param timestamps Posortowana rosnco kolumna znacznikw czasu.
+    /// \param values Kolumny wartoci, indeksowane numerem kanau.
+    /// \param count Liczba wierszy.
+    /// \param owner Obiekt utrzymujcy pami kolumn przy yciu (np. odwzorowany plik).
+    /// \details Dotychczasowa zawarto magazynu jest usuwana. Dane nie s kopiowane ani sprawdzane.
+    void attach(const int32_t* timestamps, const float* const values[CHANNEL_COUNT], size_t count,
+        std::shared_ptr<const void> owner);
+
+    /// \brief Sprawdza, czy kolumny s wypoyczone z zewntrznej pamici.
+    bool isBorrowed() const { return owner != nullptr; }
+
+    /// \brief Kopiuje wypoyczone kolumny do wasnych wektorw i zwalnia wypoyczon pami.
+    /// \details Wywoywana przed kad modyfikacj; dla wasnych kolumn nic nie robi.
+    void detach();
+
+    /// \brief Wstawia wiersz z zachowaniem porzdku czasowego.
+    /// \param rowData Wiersz danych do wstawienia.
+    /// \return Pozycja, na ktrej wiersz zosta zapisany.
+    /// \details Wiersze dopisywane chronologicznie trafiaj na koniec kolumn w czasie staym.
+    /// Wiersz starszy od ostatniego jest wstawiany za wszystkimi wierszami o tym samym lub wczeniejszym czasie.
+    size_t insert(const RowData& rowData);
+
+    /// \brief Rezerwuje miejsce na podan liczb wierszy we wszystkich kolumnach.
+    /// \param count Oczekiwana liczba wierszy.
+    void reserve(size_t count);
+
+    /// \brief Usuwa wszystkie wiersze z magazynu.
+    void clear();
+
+    /// \brief Ustawia liczb wierszy we wszystkich kolumnach (jedna alokacja na kolumn).
+    /// \param count Nowa liczba wierszy.
+    /// \details Suy do hurtowego wczytywania kolumn, np. z pliku migawki. Wywoujcy odpowiada za wypenienie
+    /// kolumn przez mutableTimestamps() i mutableColumn() tak, aby zachowa porzdek czasowy.
+    void resize(size_t count);
+
+    /// \brief Zwraca modyfikowalny wskanik na kolumn znacznikw czasu (do hurtowego wczytywania).
+    int32_t* mutableTimestamps();
+
+    /// \brief Zwraca modyfikowalny wskanik na kolumn wskazanego kanau (do hurtowego wczytywania).
+    float* mutableColumn(Channel channel);
+
+    /// \brief Sprawdza, czy kolumna znacznikw czasu jest posortowana rosnco.
+    bool isSorted() const;
+
+    /// \brief Zwraca liczb przechowywanych wierszy.
+    size_t size() const { return count; }
+
+    /// \brief Sprawdza, czy magazyn jest pusty.
+    bool empty() const { return count == 0; }
+
+    /// \brief Zwraca znacznik czasu wiersza na podanej pozycji.
+    int32_t timestampAt(size_t index) const { return timestampData[index]; }
+
+    /// \brief Zwraca warto kanau dla wiersza na podanej pozycji.
+    float valueAt(Channel channel, size_t index) const { return valueData[static_cast<int>(channel)][index]; }
+
+    /// \brief Zwraca wskanik na pocztek kolumny znacznikw czasu.
+    const int32_t* timestamps() const { return timestampData; }
+
+    /// \brief Zwraca wskanik na pocztek kolumny wskazanego kanau.
+    const float* column(Channel channel) const { return valueData[static_cast<int>(channel)]; }
+
+    /// \brief Wyszukuje binarnie pierwszy wiersz o czasie nie wczeniejszym ni podany.
+    /// \param timestamp Szukany znacznik czasu.
+    /// \return Pozycja pierwszego wiersza z czasem >= timestamp lub size(), jeli taki nie istnieje.
+    size_t lowerBound(int32_t timestamp) const;
+
+    /// \brief Wyszukuje binarnie pierwszy wiersz o czasie pniejszym ni podany.
+    /// \param timestamp Szukany znacznik czasu.
+    /// \return Pozycja pierwszego wiersza z czasem > timestamp lub size(), jeli taki nie istnieje.
+    size_t upperBound(int32_t timestamp) const;
+
+    /// \brief Odtwarza obiekt RowData z wiersza na podanej pozycji.
+    /// \param index Pozycja wiersza.
+    /// \return Kopia wiersza w postaci obiektu RowData.
+    RowData rowAt(size_t index) const;
+
+private:
+    /// \brief Ustawia wskaniki odczytu na wasne wektory.
+    void bindOwned();
+
+    std::vector<int32_t> timestampColumn; ///< Kolumna znacznikw czasu (minuty od 01.01.1970), posortowana rosnco.
+    std::vector<float> valueColumns[CHANNEL_COUNT]; ///< Kolumny wartoci, indeksowane numerem kanau (Channel).
+    const int32_t* timestampData; ///< Odczytywana kolumna znacznikw czasu (wasna lub wypoyczona).
+    const float* valueData[CHANNEL_COUNT]; ///< Odczytywane kolumny wartoci (wasne lub wypoyczone).
+    size_t count; ///< Liczba wierszy.
+    std::shared_ptr<const void> owner; ///< Waciciel wypoyczonej pamici; pusty dla wasnych kolumn.
+};
+
+#endif // COLUMNSTORE_H
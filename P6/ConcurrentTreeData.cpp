@@ -0,0 +1,113 @@
+/// \file ConcurrentTreeData.cpp
+/// \brief Implementacja drzewa danych odczytywanego wspbienie z wczytywaniem.
+
+#include "ConcurrentTreeData.h"
+
+/// \brief Tworzy puste drzewo (opublikowana jest pusta wersja).
+ConcurrentTreeData::ConcurrentTreeData()
+    : replicas(std::make_shared<Replicas>()), published(0), spareStale(false), currentVersion(0) {
+    for (int replica = 0; replica < 2; ++replica) {
+        replicas->trees[replica] = std::make_shared<TreeData>();
+        replicas->released[replica] = true;
+    }
+    std::atomic_store(&current, makeSnapshot(published));
+}
+
+/// \brief Tworzy wskanik publikujcy kopi drzewa; jego usunicie oznacza kopi jako zwolnion.
+/// \param replica Numer kopii (0 lub 1).
+/// \details Funkcja zwalniajca utrzymuje drzewo przy yciu a do zakoczenia pracy ostatniego czytelnika tej
+/// wersji, wic wszystkie jego odczyty poprzedzaj pniejsz modyfikacj kopii przez publish(). Jeli w tym
+/// czasie kopia zostaa zastpiona nowym drzewem, stare drzewo jest po prostu usuwane.
+ConcurrentTreeData::Snapshot ConcurrentTreeData::makeSnapshot(int replica) {
+    std::shared_ptr<Replicas> shared = replicas;
+    std::shared_ptr<TreeData> tree;
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->released[replica] = false;
+        tree = shared->trees[replica];
+    }
+    const TreeData* view = tree.get();
+    return Snapshot(view, [shared, replica, tree](const TreeData*) {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        if (shared->trees[replica] == tree) {
+            shared->released[replica] = true;
+        }
+    });
+}
+
+/// \brief Dodaje wiersz do bufora wierszy oczekujcych na publikacj.
+void ConcurrentTreeData::addData(const RowData& rowData) {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pending.push_back(rowData);
+}
+
+/// \brief Zwraca liczb wierszy oczekujcych na publikacj.
+size_t ConcurrentTreeData::pendingCount() const {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    return pending.size();
+}
+
+/// \brief Publikuje now wersj drzewa, zawierajc wszystkie dotychczas dodane wiersze.
+/// \details Po podmianie wskanika nowe wiersze staj si zalegoci (lagging) dla drugiej kopii.
+size_t ConcurrentTreeData::publish() {
+    std::lock_guard<std::mutex> publishLock(publishMutex);
+    std::vector<RowData> batch;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        batch.swap(pending);  ///< Bufor jest od razu gotowy na kolejne wiersze
+    }
+    if (batch.empty()) {
+        return 0;
+    }
+
+    int spare = 1 - published;
+    try {
+        prepareSpare(spare, batch);
+    }
+    catch (...) {
+        // Przywrcenie wierszy do bufora, przed wierszami dodanymi w trakcie publikacji
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        batch.insert(batch.end(), pending.begin(), pending.end());
+        batch.swap(pending);
+        throw;
+    }
+
+    std::atomic_store(&current, makeSnapshot(spare));  ///< Od tej chwili nowi czytelnicy widz now wersj
+    published = spare;
+    lagging.swap(batch);
+    currentVersion.fetch_add(1, std::memory_order_release);
+    return lagging.size();
+}
+
+/// \brief Przygotowuje kopi zapasow z nowymi wierszami, w miejscu albo przez skopiowanie opublikowanej.
+/// \details Opublikowane drzewo jest niezmienne, wic mona je kopiowa rwnolegle z odczytami czytelnikw.
+/// Kopia powstaje poza blokad i zastpuje kopi zapasow dopiero wtedy, gdy jest kompletna.
+void ConcurrentTreeData::prepareSpare(int spare, const std::vector<RowData>& batch) {
+    std::shared_ptr<TreeData> tree;
+    {
+        std::lock_guard<std::mutex> lock(replicas->mutex);
+        if (replicas->released[spare] && !spareStale) {
+            tree = replicas->trees[spare];
+        }
+    }
+
+    if (tree) {
+        spareStale = true;  ///< Na czas aktualizacji - wyjtek pozostawiby kopi czciowo uzupenion
+        tree->addBatch(lagging);
+        tree->addBatch(batch);
+        spareStale = false;
+        return;
+    }
+
+    std::shared_ptr<const TreeData> source = snapshot();
+    std::shared_ptr<TreeData> copy = std::make_shared<TreeData>(*source);
+    copy->addBatch(batch);
+    std::lock_guard<std::mutex> lock(replicas->mutex);
+    replicas->trees[spare] = copy;  ///< Trzymana przez czytelnikw wersja jest usuwana wraz z ostatnim z nich
+    spareStale = false;
+}
+
+/// \brief Zwraca biec opublikowan wersj drzewa.
+ConcurrentTreeData::Snapshot ConcurrentTreeData::snapshot() const {
+    return std::atomic_load(&current);
+}
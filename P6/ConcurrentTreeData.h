@@ -0,0 +1,95 @@
+/// \file ConcurrentTreeData.h
+/// \brief Deklaracja klasy ConcurrentTreeData - drzewa danych odczytywanego wspbienie z wczytywaniem.
+
+#ifndef CONCURRENTTREEDATA_H
+#define CONCURRENTTREEDATA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "TreeData.h" ///< Drzewo danych, ktrego wersje s publikowane.
+
+/// \class ConcurrentTreeData
+/// \brief Udostpnia czytelnikom niezmienne wersje drzewa danych, podczas gdy nowe wiersze s wczytywane.
+/// Wiersze dodawane przez addData trafiaj do bufora i staj si widoczne dopiero po publish(). Czytelnik
+/// pobiera biec wersj przez snapshot() - kopi wskanika std::shared_ptr - i wykonuje na niej dowolne
+/// zapytania bez blokad, a publikacja kolejnej wersji nie zmienia drzewa, ktre czytelnik ju trzyma.
+/// Klasa przechowuje dwie kopie drzewa (technika lewo-prawo): publish() dopisuje wiersze do kopii nieuywanej
+/// przez czytelnikw, podmienia wskanik i przy nastpnej publikacji uzupenia drug kopi tymi samymi
+/// wierszami. Koszt publikacji zaley wic od liczby nowych wierszy, a nie od rozmiaru drzewa, za cen
+/// dwukrotnego zuycia pamici. Jeli czytelnik wci trzyma kopi zapasow, publikacja na niego nie czeka,
+/// tylko kopiuje opublikowane drzewo (jak w RCU), a trzymana wersja jest usuwana po jej zwolnieniu.
+class ConcurrentTreeData {
+public:
+    using Snapshot = std::shared_ptr<const TreeData>; ///< Niezmienna wersja drzewa udostpniana czytelnikom.
+
+    /// \brief Tworzy puste drzewo (opublikowana jest pusta wersja).
+    ConcurrentTreeData();
+
+    ConcurrentTreeData(const ConcurrentTreeData&) = delete;
+    ConcurrentTreeData& operator=(const ConcurrentTreeData&) = delete;
+
+    /// \brief Dodaje wiersz do bufora wierszy oczekujcych na publikacj.
+    /// \param rowData Wiersz danych.
+    /// \details Moe by wywoywana z wielu wtkw jednoczenie; nie czeka na czytelnikw ani na publish().
+    void addData(const RowData& rowData);
+
+    /// \brief Zwraca liczb wierszy oczekujcych na publikacj.
+    size_t pendingCount() const;
+
+    /// \brief Publikuje now wersj drzewa, zawierajc wszystkie dotychczas dodane wiersze.
+    /// \return Liczba wierszy, ktre stay si widoczne dla czytelnikw.
+    /// \throws std::bad_alloc Gdy zabraknie pamici; wiersze wracaj wtedy do bufora, a opublikowana wersja
+    /// si nie zmienia.
+    /// \details Funkcja nigdy nie czeka na czytelnikw. Gdy wersja sprzed poprzedniej publikacji jest zwolniona,
+    /// wiersze s dopisywane do niej; w przeciwnym razie nowa wersja powstaje z kopii biecej, wic czytelnik
+    /// trzymajcy wersj dowolnie dugo (take wtek wywoujcy publish()) zwiksza tylko koszt publikacji.
+    /// Jednoczenie moe dziaa tylko jedna publikacja; kolejne czekaj na jej zakoczenie.
+    size_t publish();
+
+    /// \brief Zwraca biec opublikowan wersj drzewa.
+    /// \details Zwrcona wersja nie zmienia si i pozostaje wana tak dugo, jak dugo czytelnik trzyma wskanik.
+    /// Widoki (RangeView) utworzone z tej wersji s wane przez ten sam czas.
+    Snapshot snapshot() const;
+
+    /// \brief Zwraca numer biecej wersji (0 dla pustego drzewa, zwikszany przez kad publikacj).
+    uint64_t version() const { return currentVersion.load(std::memory_order_acquire); }
+
+private:
+    /// \struct Replicas
+    /// \brief Dwie kopie drzewa wraz ze stanem ich zwolnienia przez czytelnikw.
+    /// Struktura jest wspdzielona z funkcjami zwalniajcymi opublikowanych wersji. Kada wersja trzyma te
+    /// wskanik na swoje drzewo, dziki czemu pozostaje wana po zastpieniu kopii nowym drzewem i po usuniciu
+    /// obiektu ConcurrentTreeData.
+    struct Replicas {
+        std::shared_ptr<TreeData> trees[2]; ///< Kopie drzewa: opublikowana i zapasowa.
+        bool released[2]; ///< Czy czytelnicy zwolnili kopi (ostatni wskanik na ni zosta usunity).
+        std::mutex mutex; ///< Chroni tablice trees i released.
+    };
+
+    /// \brief Tworzy wskanik publikujcy kopi drzewa; jego usunicie oznacza kopi jako zwolnion.
+    /// \param replica Numer kopii (0 lub 1).
+    Snapshot makeSnapshot(int replica);
+
+    /// \brief Przygotowuje kopi zapasow z nowymi wierszami, w miejscu albo przez skopiowanie opublikowanej.
+    /// \param spare Numer kopii zapasowej.
+    /// \param batch Nowe wiersze.
+    /// \details W razie wyjtku kopia zapasowa jest oznaczana jako nieaktualna i przy nastpnej publikacji
+    /// zastpowana kopi opublikowanego drzewa, wic wiersze nigdy nie s do niej dopisywane dwukrotnie.
+    void prepareSpare(int spare, const std::vector<RowData>& batch);
+
+    std::shared_ptr<Replicas> replicas; ///< Kopie drzewa.
+    Snapshot current; ///< Bieca wersja; odczytywana i podmieniana funkcjami std::atomic_load/std::atomic_store.
+    int published; ///< Numer opublikowanej kopii.
+    std::vector<RowData> lagging; ///< Wiersze poprzedniej publikacji, ktrych brakuje jeszcze w kopii zapasowej.
+    bool spareStale; ///< Czy kopia zapasowa jest niespjna (przerwana aktualizacja) i trzeba j odtworzy.
+    std::vector<RowData> pending; ///< Wiersze oczekujce na publikacj.
+    mutable std::mutex pendingMutex; ///< Chroni bufor pending.
+    std::mutex publishMutex; ///< Szereguje publikacje.
+    std::atomic<uint64_t> currentVersion; ///< Numer biecej wersji.
+};
+
+#endif // CONCURRENTTREEDATA_H
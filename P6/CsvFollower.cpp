@@ -0,0 +1,119 @@
+/// \file CsvFollower.cpp
+/// \brief Implementacja przyrostowego wczytywania dopisywanego pliku CSV.
+
+#include "CsvFollower.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+/// \brief Tworzy obiekt ledzcy plik o podanej ciece (nic jeszcze nie jest wczytywane).
+CsvFollower::CsvFollower(const std::string& path)
+    : path(path), offset(0), lastTimestamp(std::numeric_limits<int32_t>::min()), polledRows(0), restarts(0) {
+}
+
+/// \brief Wczytuje wiersze dopisane do pliku od poprzedniego wywoania.
+bool CsvFollower::poll(const CsvParser::RowCallback& onRow) {
+    return pollBatches([&onRow](std::vector<RowData>& rows) {
+        for (const auto& rowData : rows) {
+            onRow(rowData);
+        }
+    });
+}
+
+/// \brief Wczytuje wiersze dopisane do pliku od poprzedniego wywoania i przekazuje je paczkami.
+bool CsvFollower::pollBatches(const CsvParser::BatchCallback& onBatch) {
+    polledRows = 0;
+    size_t rowsBefore = parser.getRowCount();
+    const CsvParser::BatchCallback deliver = [this, &onBatch](std::vector<RowData>& rows) {
+        for (const auto& rowData : rows) {
+            lastTimestamp = std::max(lastTimestamp, rowData.getTimestamp());
+        }
+        onBatch(rows);
+    };
+
+    MappedFile mappedFile;
+    if (mappedFile.open(path)) {
+        // Sprawdzenie, czy plik nadal zawiera ostatni wczytany wiersz w tym samym miejscu
+        if (mappedFile.size() < offset || (!lastLine.empty()
+            && std::memcmp(mappedFile.data() + offset - lastLine.size(), lastLine.data(), lastLine.size()) != 0)) {
+            restart();
+        }
+        offset += parseComplete(mappedFile.data() + offset, mappedFile.size() - offset, deliver);
+    }
+    else {
+        // Odczyt strumieniowy samych nowych danych
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.seekg(0, std::ios::end);
+        size_t fileSize = static_cast<size_t>(file.tellg());
+        if (fileSize < offset) {
+            restart();
+        }
+        else if (!lastLine.empty()) {
+            std::string stored(lastLine.size(), '\0');
+            file.seekg(static_cast<std::streamoff>(offset - lastLine.size()));
+            file.read(&stored[0], static_cast<std::streamsize>(stored.size()));
+            if (stored != lastLine) {
+                restart();
+            }
+        }
+
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(offset));
+        std::vector<char> buffer(READ_BLOCK);
+        size_t pending = 0;  ///< Liczba bajtw niepenego wiersza na pocztku bufora
+        while (file) {
+            if (pending == buffer.size()) {
+                buffer.resize(buffer.size() * 2);
+            }
+            file.read(buffer.data() + pending, static_cast<std::streamsize>(buffer.size() - pending));
+            size_t available = pending + static_cast<size_t>(file.gcount());
+            size_t consumed = parseComplete(buffer.data(), available, deliver);
+            offset += consumed;
+            pending = available - consumed;
+            if (pending > 0 && consumed > 0) {
+                std::memmove(buffer.data(), buffer.data() + consumed, pending);
+            }
+        }
+    }
+
+    polledRows = parser.getRowCount() - rowsBefore;
+    return true;
+}
+
+/// \brief Parsuje pene wiersze z fragmentu pliku zaczynajcego si na pozycji offset.
+/// \details Fragment jest przycinany do ostatniego znaku nowej linii. Due fragmenty (np. przy pierwszym
+/// wczytaniu) s parsowane rwnolegle, tak jak w CsvParser::parseFile.
+size_t CsvFollower::parseComplete(const char* data, size_t size, const CsvParser::BatchCallback& onBatch) {
+    size_t complete = size;
+    while (complete > 0 && data[complete - 1] != '\n') {
+        --complete;
+    }
+    if (complete == 0) {
+        return 0;
+    }
+
+    const size_t chunkCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), complete / READ_BLOCK);
+    parser.parseBufferBatches(data, complete, onBatch, static_cast<unsigned>(std::max<size_t>(chunkCount, 1)));
+    rememberLastLine(data + complete, complete);
+    return complete;
+}
+
+/// \brief Zapamituje kocwk ostatniego penego wiersza, suc do wykrywania podmiany pliku.
+void CsvFollower::rememberLastLine(const char* lineEnd, size_t available) {
+    size_t length = available < FINGERPRINT_BYTES ? available : FINGERPRINT_BYTES;
+    lastLine.assign(lineEnd - length, length);
+}
+
+/// \brief Zaczyna ledzenie pliku od pocztku (po skrceniu lub podmianie).
+void CsvFollower::restart() {
+    offset = 0;
+    lastLine.clear();
+    ++restarts;
+}
@@ -0,0 +1,82 @@
+/// \file CsvFollower.h
+/// \brief Deklaracja klasy CsvFollower - przyrostowego wczytywania dopisywanego pliku CSV.
+
+#ifndef CSVFOLLOWER_H
+#define CSVFOLLOWER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "CsvParser.h" ///< Parser wierszy CSV.
+
+/// \class CsvFollower
+/// \brief ledzi plik CSV, do ktrego dopisywane s nowe wiersze, i przy kadym poll() wczytuje tylko nowe dane.
+/// Obiekt pamita pozycj (w bajtach) za ostatnim wczytanym penym wierszem, znacznik czasu najnowszego wiersza
+/// oraz tre ostatniego wczytanego wiersza. Niepeny wiersz na kocu pliku (w trakcie zapisu) nie jest wczytywany
+/// - zostanie wczytany w caoci przy kolejnym poll(). Jeli plik jest krtszy ni zapamitana pozycja albo
+/// w miejscu ostatniego wiersza znajduje si inna tre, plik uznaje si za skrcony lub podmieniony i jest
+/// wczytywany od pocztku; powtrzone wiersze odrzuca wtedy odbiorca (np. TreeData::addDataUnique).
+class CsvFollower {
+public:
+    /// \brief Tworzy obiekt ledzcy plik o podanej ciece (nic jeszcze nie jest wczytywane).
+    /// \param path cieka do pliku CSV.
+    explicit CsvFollower(const std::string& path);
+
+    /// \brief Wczytuje wiersze dopisane do pliku od poprzedniego wywoania.
+    /// \param onRow Funkcja wywoywana dla kadego poprawnego nowego wiersza, w kolejnoci z pliku.
+    /// \return true, jeli plik udao si otworzy, false w przeciwnym razie.
+    /// \details Koszt zaley od liczby nowych bajtw, a nie od rozmiaru pliku. Zwyke pliki s odwzorowywane
+    /// w pamici, a due przyrosty (np. pierwsze wczytanie) parsowane rwnolegle; gdy odwzorowanie si nie uda
+    /// (np. plik jest otwarty do zapisu przez inny proces w systemie Windows), nowe dane s czytane strumieniowo.
+    bool poll(const CsvParser::RowCallback& onRow);
+
+    /// \brief Wczytuje wiersze dopisane do pliku od poprzedniego wywoania i przekazuje je paczkami.
+    /// \param onBatch Funkcja wywoywana dla kolejnych paczek poprawnych nowych wierszy, w kolejnoci z pliku.
+    /// \return true, jeli plik udao si otworzy, false w przeciwnym razie.
+    /// \details Paczk mona przekaza wprost do TreeData::addBatch, bez kopiowania wierszy.
+    bool pollBatches(const CsvParser::BatchCallback& onBatch);
+
+    /// \brief Zwraca pozycj w pliku (w bajtach) za ostatnim wczytanym penym wierszem.
+    size_t getOffset() const { return offset; }
+
+    /// \brief Zwraca znacznik czasu najnowszego wczytanego wiersza (INT32_MIN, jeli nic nie wczytano).
+    int32_t getLastTimestamp() const { return lastTimestamp; }
+
+    /// \brief Zwraca liczb poprawnych wierszy wczytanych przez ostatnie wywoanie poll().
+    size_t getPolledRowCount() const { return polledRows; }
+
+    /// \brief Zwraca liczb wykrytych skrce lub podmian pliku.
+    size_t getRestartCount() const { return restarts; }
+
+    /// \brief Zwraca parser uywany do wczytywania (liczniki wierszy i bdw od utworzenia obiektu).
+    const CsvParser& getParser() const { return parser; }
+
+private:
+    /// \brief Parsuje pene wiersze z fragmentu pliku zaczynajcego si na pozycji offset.
+    /// \param data Dane od pozycji offset.
+    /// \param size Liczba dostpnych bajtw.
+    /// \param onBatch Funkcja wywoywana dla paczek poprawnych wierszy.
+    /// \return Liczba bajtw do koca ostatniego penego wiersza (0, jeli nie ma penego wiersza).
+    size_t parseComplete(const char* data, size_t size, const CsvParser::BatchCallback& onBatch);
+
+    /// \brief Zapamituje kocwk ostatniego penego wiersza, suc do wykrywania podmiany pliku.
+    /// \param lineEnd Wskanik za znakiem nowej linii koczcym wiersz.
+    /// \param available Liczba bajtw przed lineEnd, ktre mona odczyta.
+    void rememberLastLine(const char* lineEnd, size_t available);
+
+    /// \brief Zaczyna ledzenie pliku od pocztku (po skrceniu lub podmianie).
+    void restart();
+
+    static const size_t FINGERPRINT_BYTES = 128; ///< Maksymalna dugo zapamitanej kocwki ostatniego wiersza.
+    static const size_t READ_BLOCK = 1 << 20; ///< Rozmiar bloku przy odczycie strumieniowym.
+
+    std::string path; ///< cieka do ledzonego pliku.
+    CsvParser parser; ///< Parser wierszy CSV.
+    size_t offset; ///< Pozycja za ostatnim wczytanym penym wierszem.
+    int32_t lastTimestamp; ///< Znacznik czasu najnowszego wczytanego wiersza.
+    std::string lastLine; ///< Kocwka ostatniego wczytanego wiersza (razem ze znakiem nowej linii).
+    size_t polledRows; ///< Liczba wierszy wczytanych przez ostatnie poll().
+    size_t restarts; ///< Liczba wykrytych skrce lub podmian pliku.
+};
+
+#endif // CSVFOLLOWER_H
@@ -0,0 +1,292 @@
+/// \file CsvParser.cpp
+/// \brief Implementacja jednoprzebiegowego parsera plikw CSV z eksportu danych.
+
+#include "CsvParser.h"
+#include "LineValidation.h"
+#include "LogManager.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+/// \brief Sprawdza, czy znak jest liter alfabetu aciskiego.
+static bool isLetter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+/// \brief Zawa pole CSV, pomijajc otaczajce je spacje i cudzysowy.
+static void trimField(const char*& begin, const char*& end) {
+    while (begin < end && (*begin == '"' || *begin == ' ')) ++begin;
+    while (end > begin && (end[-1] == '"' || end[-1] == ' ')) --end;
+}
+
+/// \brief Konstruktor parsera.
+/// \param bufferSize Rozmiar bufora odczytu w bajtach.
+CsvParser::CsvParser(size_t bufferSize) : buffer(bufferSize > 0 ? bufferSize : 1), rowCount(0), errorCount(0) {
+}
+
+/// \brief Analizuje jeden wiersz CSV.
+/// \details Jeden przebieg po znakach wiersza zbiera pozycje przecinkw i wykrywa litery. Kolejno sprawdze
+/// (pusta linia, nagwek, litery, liczba parametrw) jest taka sama jak w lineValidation. Pola s nastpnie
+/// konwertowane bezporednio z bufora: data przez parseTimestamp, a wartoci przez std::from_chars.
+LineStatus CsvParser::parseLine(const char* begin, const char* end, int32_t& timestamp, float values[CHANNEL_COUNT]) {
+    if (end > begin && end[-1] == '\r') {
+        --end;  ///< Pominicie znaku '\r' z plikw zapisanych w systemie Windows
+    }
+    if (begin == end) {
+        return LineStatus::Empty;
+    }
+
+    const char* separators[CHANNEL_COUNT];  ///< Pozycje przecinkw rozdzielajcych pola
+    int commaCount = 0;
+    bool hasLetter = false;
+    for (const char* it = begin; it != end; ++it) {
+        if (*it == ',') {
+            if (commaCount < CHANNEL_COUNT) {
+                separators[commaCount] = it;
+            }
+            ++commaCount;
+        }
+        else if (isLetter(*it)) {
+            hasLetter = true;
+        }
+    }
+
+    if (hasLetter) {
+        // Tylko wiersze z literami mog zawiera nagwek, wic wyszukiwanie "Time" odbywa si wycznie tutaj
+        for (const char* it = begin; it + 4 <= end; ++it) {
+            if (std::memcmp(it, "Time", 4) == 0) {
+                return LineStatus::Header;
+            }
+        }
+        return LineStatus::OtherData;
+    }
+    if (commaCount != CHANNEL_COUNT) {
+        return LineStatus::WrongFieldCount;
+    }
+
+    const char* fieldBegin = begin;
+    const char* fieldEnd = separators[0];
+    trimField(fieldBegin, fieldEnd);
+    if (!parseTimestamp(fieldBegin, fieldEnd, timestamp)) {
+        return LineStatus::InvalidValue;
+    }
+
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        fieldBegin = separators[channel] + 1;
+        fieldEnd = channel + 1 < CHANNEL_COUNT ? separators[channel + 1] : end;
+        trimField(fieldBegin, fieldEnd);
+        std::from_chars_result result = std::from_chars(fieldBegin, fieldEnd, values[channel]);
+        if (result.ec != std::errc() || result.ptr != fieldEnd) {
+            return LineStatus::InvalidValue;
+        }
+    }
+    return LineStatus::Valid;
+}
+
+/// \brief Parsuje wszystkie pene wiersze z bufora w pamici.
+/// \param data Wskanik na pocztek danych.
+/// \param size Rozmiar danych w bajtach.
+/// \param onRow Funkcja wywoywana dla kadego poprawnego wiersza.
+/// \param final true, jeli dane kocz plik.
+/// \return Liczba bajtw przetworzonych (do koca ostatniego penego wiersza).
+size_t CsvParser::parseBuffer(const char* data, size_t size, const RowCallback& onRow, bool final) {
+    const char* lineBegin = data;
+    const char* end = data + size;
+
+    while (lineBegin < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(lineBegin, '\n', end - lineBegin));
+        if (lineEnd == nullptr) {
+            if (!final) {
+                break;  ///< Niepeny wiersz - zostanie dokoczony w kolejnym bloku
+            }
+            lineEnd = end;
+        }
+        processLine(lineBegin, lineEnd, onRow);
+        lineBegin = lineEnd < end ? lineEnd + 1 : end;
+    }
+    return lineBegin - data;
+}
+
+/// \struct ParseChunk
+/// \brief Fragment bufora parsowany przez jeden wtek wraz z lokalnymi wynikami.
+struct ParseChunk {
+    const char* begin; ///< Pocztek fragmentu (pocztek wiersza).
+    const char* end; ///< Koniec fragmentu (za znakiem nowej linii lub koniec danych).
+    std::vector<RowData> rows; ///< Poprawne wiersze fragmentu w kolejnoci z pliku.
+    size_t errors; ///< Liczba odrzuconych wierszy we fragmencie.
+};
+
+/// \brief Parsuje bufor w pamici rwnolegle na kilku wtkach.
+/// \param data Wskanik na pocztek danych (caego pliku).
+/// \param size Rozmiar danych w bajtach.
+/// \param onRow Funkcja wywoywana dla kadego poprawnego wiersza.
+/// \param threadCount Liczba wtkw (0 - liczba rdzeni procesora).
+/// \return Liczba poprawnie wczytanych wierszy.
+size_t CsvParser::parseBufferParallel(const char* data, size_t size, const RowCallback& onRow, unsigned threadCount) {
+    return parseBufferBatches(data, size, [&onRow](std::vector<RowData>& rows) {
+        for (const auto& rowData : rows) {
+            onRow(rowData);
+        }
+    }, threadCount);
+}
+
+/// \brief Parsuje bufor w pamici rwnolegle i przekazuje wiersze paczkami, po jednej na fragment.
+/// \param data Wskanik na pocztek danych (caego pliku).
+/// \param size Rozmiar danych w bajtach.
+/// \param onBatch Funkcja wywoywana dla wierszy kadego fragmentu.
+/// \param threadCount Liczba fragmentw (0 - liczba rdzeni procesora).
+/// \return Liczba poprawnie wczytanych wierszy.
+/// \details Wtki nie s tworzone dla kadego wywoania - fragmenty wykonuje wsplna pula, ktra docza
+/// wszystkie zadania take wtedy, gdy ktre z nich rzuci wyjtek.
+size_t CsvParser::parseBufferBatches(const char* data, size_t size, const BatchCallback& onBatch, unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Podzia na fragmenty - kada granica przesuwana jest za najbliszy znak nowej linii
+    std::vector<ParseChunk> chunks;
+    const char* end = data + size;
+    const char* chunkBegin = data;
+    for (unsigned i = 1; i <= threadCount && chunkBegin < end; ++i) {
+        const char* chunkEnd = i == threadCount ? end : data + size / threadCount * i;
+        if (chunkEnd < chunkBegin) {
+            chunkEnd = chunkBegin;
+        }
+        if (chunkEnd < end) {
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = newline != nullptr ? newline + 1 : end;
+        }
+        chunks.push_back(ParseChunk{ chunkBegin, chunkEnd, std::vector<RowData>(), 0 });
+        chunkBegin = chunkEnd;
+    }
+
+    // Rwnolege parsowanie fragmentw do lokalnych wektorw
+    ThreadPool::shared().parallelFor(chunks.size(), [&chunks](size_t chunkIndex) {
+        ParseChunk& chunk = chunks[chunkIndex];
+        int32_t timestamp;
+        float values[CHANNEL_COUNT];
+        const char* lineBegin = chunk.begin;
+        while (lineBegin < chunk.end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(lineBegin, '\n', chunk.end - lineBegin));
+            if (lineEnd == nullptr) {
+                lineEnd = chunk.end;
+            }
+            if (acceptLine(lineBegin, lineEnd, timestamp, values)) {
+                chunk.rows.emplace_back(timestamp, values[0], values[1], values[2], values[3], values[4]);
+            }
+            else {
+                ++chunk.errors;
+            }
+            lineBegin = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+        }
+    });
+
+    // Przekazanie fragmentw w kolejnoci z pliku
+    size_t rowsBefore = rowCount;
+    for (auto& chunk : chunks) {
+        rowCount += chunk.rows.size();
+        errorCount += chunk.errors;
+        if (!chunk.rows.empty()) {
+            onBatch(chunk.rows);
+        }
+        std::vector<RowData>().swap(chunk.rows);  ///< Zwolnienie pamici przekazanego fragmentu
+    }
+    return rowCount - rowsBefore;
+}
+
+/// \brief Parsuje cay strumie, odczytujc go duymi blokami.
+/// \details Niepeny wiersz z koca bloku jest przenoszony na pocztek bufora i uzupeniany kolejnym odczytem.
+/// Jeli pojedynczy wiersz nie mieci si w buforze, bufor jest powikszany.
+size_t CsvParser::parseStream(std::istream& in, const RowCallback& onRow) {
+    size_t rowsBefore = rowCount;
+    size_t pending = 0;  ///< Liczba bajtw niepenego wiersza na pocztku bufora
+
+    while (in) {
+        if (pending == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        in.read(buffer.data() + pending, buffer.size() - pending);
+        size_t available = pending + static_cast<size_t>(in.gcount());
+        bool final = !in;
+
+        size_t consumed = parseBuffer(buffer.data(), available, onRow, final);
+        pending = available - consumed;
+        if (pending > 0 && consumed > 0) {
+            std::memmove(buffer.data(), buffer.data() + consumed, pending);
+        }
+    }
+    return rowCount - rowsBefore;
+}
+
+/// \brief Parsuje plik o podanej nazwie.
+/// \param path cieka do pliku CSV.
+/// \param onRow Funkcja wywoywana dla kadego poprawnego wiersza.
+/// \return true, jeli plik udao si otworzy, false w przeciwnym razie.
+bool CsvParser::parseFile(const std::string& path, const RowCallback& onRow) {
+    MappedFile mappedFile;
+    if (mappedFile.open(path)) {
+        // Parsowanie bezporednio w odwzorowanym pliku; due pliki s dzielone midzy wtki
+        size_t threadCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+            mappedFile.size() / MIN_PARALLEL_CHUNK);
+        if (threadCount > 1) {
+            parseBufferParallel(mappedFile.data(), mappedFile.size(), onRow, static_cast<unsigned>(threadCount));
+        }
+        else {
+            parseBuffer(mappedFile.data(), mappedFile.size(), onRow, true);
+        }
+        return true;
+    }
+
+    // Odczyt buforowany dla potokw i plikw, ktrych nie mona odwzorowa w pamici
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    parseStream(file, onRow);
+    return true;
+}
+
+/// \brief Loguje odrzucony wiersz komunikatem odpowiadajcym jego kategorii.
+/// \details Dla kategorii sprawdzanych przez lineValidation komunikat jest generowany przez t sam funkcj,
+/// dziki czemu log bdw i licznik errorLogCount s takie same jak przy wczytywaniu wiersz po wierszu.
+void CsvParser::reportLine(LineStatus status, const char* begin, const char* end) {
+    if (end > begin && end[-1] == '\r') {
+        --end;
+    }
+    std::string line(begin, end);  ///< Kopia wiersza tworzona tylko na potrzeby komunikatu o bdzie
+    if (status == LineStatus::InvalidValue) {
+        P6_LOG_ERROR(errorLogger, "Nieprawidowa warto: " + line);
+    }
+    else {
+        lineValidation(line);
+    }
+}
+
+/// \brief Parsuje wiersz i loguje wynik (wczytany wiersz albo bd).
+/// \details Funkcja nie modyfikuje stanu parsera, dziki czemu moe by wywoywana rwnolegle z wielu wtkw.
+bool CsvParser::acceptLine(const char* begin, const char* end, int32_t& timestamp, float values[CHANNEL_COUNT]) {
+    LineStatus status = parseLine(begin, end, timestamp, values);
+    if (status != LineStatus::Valid) {
+        reportLine(status, begin, end);
+        return false;
+    }
+    // Wiersz jest formatowany tylko wtedy, gdy poziom Trace jest wczony
+    P6_LOG_TRACE(globalLogger, "Wczytano linie: " + RowData(timestamp, values[0], values[1], values[2], values[3], values[4]).toString());
+    return true;
+}
+
+/// \brief Przetwarza jeden wiersz: wywouje onRow albo loguje bd.
+void CsvParser::processLine(const char* begin, const char* end, const RowCallback& onRow) {
+    int32_t timestamp;
+    float values[CHANNEL_COUNT];
+    if (!acceptLine(begin, end, timestamp, values)) {
+        ++errorCount;
+        return;
+    }
+    ++rowCount;
+    onRow(RowData(timestamp, values[0], values[1], values[2], values[3], values[4]));
+}
@@ -0,0 +1,120 @@
+/// \file CsvParser.h
+/// \brief Deklaracja klasy CsvParser - jednoprzebiegowego parsera plikw CSV z eksportu danych.
+
+#ifndef CSVPARSER_H
+#define CSVPARSER_H
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+#include "RowData.h" ///< Zaczenie pliku nagwkowego zawierajcego klas RowData.
+
+/// \enum LineStatus
+/// \brief Wynik analizy pojedynczego wiersza CSV, zgodny z kategoriami bdw funkcji lineValidation.
+enum class LineStatus {
+    Valid, ///< Poprawny wiersz danych.
+    Empty, ///< Pusta linia.
+    Header, ///< Wiersz nagwka (zawiera "Time").
+    OtherData, ///< Wiersz zawierajcy litery.
+    WrongFieldCount, ///< Nieprawidowa liczba parametrw (inna ni 5 przecinkw).
+    InvalidValue ///< Niepoprawna data lub warto liczbowa.
+};
+
+/// \class CsvParser
+/// \brief Strumieniowy parser plikw CSV dziaajcy na duym buforze odczytu.
+/// Kady wiersz jest analizowany jednym przebiegiem: walidacja, usuwanie cudzysoww i konwersja liczb
+/// (std::from_chars) odbywaj si bezporednio na znakach bufora, bez tworzenia tymczasowych obiektw string.
+/// Niepoprawne wiersze s logowane przez errorLogger z tymi samymi komunikatami, co w lineValidation.
+class CsvParser {
+public:
+    /// \brief Funkcja wywoywana dla kadego poprawnie sparsowanego wiersza.
+    typedef std::function<void(const RowData&)> RowCallback;
+
+    /// \brief Funkcja wywoywana dla paczki poprawnie sparsowanych wierszy (kolejnych wierszy z pliku).
+    /// Odbiorca moe przej zawarto wektora, np. przekazujc go do TreeData::addBatch.
+    typedef std::function<void(std::vector<RowData>&)> BatchCallback;
+
+    /// \brief Konstruktor parsera.
+    /// \param bufferSize Rozmiar bufora odczytu w bajtach (domylnie 1 MiB).
+    explicit CsvParser(size_t bufferSize = 1 << 20);
+
+    /// \brief Analizuje jeden wiersz CSV.
+    /// \param begin Wskanik na pocztek wiersza.
+    /// \param end Wskanik za kocem wiersza (bez znaku nowej linii).
+    /// \param[out] timestamp Znacznik czasu wiersza (tylko dla LineStatus::Valid).
+    /// \param[out] values Wartoci piciu kanaw w kolejnoci z pliku (tylko dla LineStatus::Valid).
+    /// \return Kategoria wiersza.
+    static LineStatus parseLine(const char* begin, const char* end, int32_t& timestamp, float values[CHANNEL_COUNT]);
+
+    /// \brief Parsuje wszystkie pene wiersze z bufora w pamici.
+    /// \param data Wskanik na pocztek danych.
+    /// \param size Rozmiar danych w bajtach.
+    /// \param onRow Funkcja wywoywana dla kadego poprawnego wiersza.
+    /// \param final true, jeli dane kocz plik - wtedy ostatni wiersz bez znaku nowej linii te jest parsowany.
+    /// \return Liczba bajtw przetworzonych (do koca ostatniego penego wiersza).
+    size_t parseBuffer(const char* data, size_t size, const RowCallback& onRow, bool final = true);
+
+    /// \brief Parsuje bufor w pamici rwnolegle na kilku wtkach.
+    /// \param data Wskanik na pocztek danych (caego pliku).
+    /// \param size Rozmiar danych w bajtach.
+    /// \param onRow Funkcja wywoywana dla kadego poprawnego wiersza.
+    /// \param threadCount Liczba wtkw (0 - liczba rdzeni procesora).
+    /// \return Liczba poprawnie wczytanych wierszy.
+    /// \details Dziaa jak parseBufferBatches, ale przekazuje wiersze pojedynczo, w kolejnoci z pliku.
+    size_t parseBufferParallel(const char* data, size_t size, const RowCallback& onRow, unsigned threadCount = 0);
+
+    /// \brief Parsuje bufor w pamici rwnolegle i przekazuje wiersze paczkami, po jednej na fragment.
+    /// \param data Wskanik na pocztek danych (caego pliku).
+    /// \param size Rozmiar danych w bajtach.
+    /// \param onBatch Funkcja wywoywana dla wierszy kadego fragmentu, w kolejnoci fragmentw w pliku.
+    /// \param threadCount Liczba fragmentw (0 - liczba rdzeni procesora).
+    /// \return Liczba poprawnie wczytanych wierszy.
+    /// \details Bufor jest dzielony na fragmenty wyrwnane do granic wierszy, parsowane do lokalnych wektorw
+    /// we wsplnej puli wtkw (ThreadPool::shared). onBatch wywoywane jest tylko z wtku wywoujcego, po
+    /// zakoczeniu parsowania, a kolejno wierszy i liczba bdw s takie same jak przy parsowaniu jednowtkowym.
+    /// Budowa struktury danych z paczek pozostaje szeregowa - paczki trafiaj jednak do niej w caoci
+    /// (TreeData::addBatch), a nie wiersz po wierszu.
+    size_t parseBufferBatches(const char* data, size_t size, const BatchCallback& onBatch, unsigned threadCount = 0);
+
+    /// \brief Parsuje cay strumie, odczytujc go duymi blokami.
+    /// \param in Strumie wejciowy (najlepiej otwarty w trybie binarnym).
+    /// \param onRow Funkcja wywoywana dla kadego poprawnego wiersza.
+    /// \return Liczba poprawnie wczytanych wierszy.
+    size_t parseStream(std::istream& in, const RowCallback& onRow);
+
+    /// \brief Parsuje plik o podanej nazwie.
+    /// \param path cieka do pliku CSV.
+    /// \param onRow Funkcja wywoywana dla kadego poprawnego wiersza.
+    /// \return true, jeli plik udao si otworzy, false w przeciwnym razie.
+    /// \details Zwyke pliki s odwzorowywane w pamici (MappedFile) i parsowane w miejscu, bez kopiowania wierszy,
+    /// a due pliki dodatkowo rwnolegle (parseBufferParallel). Potoki i pliki, ktrych nie da si odwzorowa,
+    /// s czytane strumieniowo przez parseStream.
+    bool parseFile(const std::string& path, const RowCallback& onRow);
+
+    /// \brief Zwraca liczb poprawnych wierszy przetworzonych przez parser.
+    size_t getRowCount() const { return rowCount; }
+
+    /// \brief Zwraca liczb odrzuconych wierszy przetworzonych przez parser.
+    size_t getErrorCount() const { return errorCount; }
+
+private:
+    /// \brief Loguje odrzucony wiersz komunikatem odpowiadajcym jego kategorii.
+    static void reportLine(LineStatus status, const char* begin, const char* end);
+
+    /// \brief Parsuje wiersz i loguje wynik (wczytany wiersz albo bd).
+    /// \return true, jeli wiersz jest poprawny.
+    static bool acceptLine(const char* begin, const char* end, int32_t& timestamp, float values[CHANNEL_COUNT]);
+
+    /// \brief Przetwarza jeden wiersz: wywouje onRow albo loguje bd.
+    void processLine(const char* begin, const char* end, const RowCallback& onRow);
+
+    static const size_t MIN_PARALLEL_CHUNK = 1 << 20; ///< Minimalny rozmiar fragmentu przypadajcy na jeden wtek.
+
+    std::vector<char> buffer; ///< Bufor odczytu strumienia.
+    size_t rowCount; ///< Liczba poprawnych wierszy.
+    size_t errorCount; ///< Liczba odrzuconych wierszy.
+};
+
+#endif // CSVPARSER_H
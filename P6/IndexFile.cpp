@@ -0,0 +1,199 @@
+/// \file IndexFile.cpp
+/// \brief Implementacja pliku indeksu danych odwzorowywanego w pamici.
+
+#include "IndexFile.h"
+#include "Snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+static_assert(sizeof(RollupRecord) == 136, "Rekord statystyk musi mie stay rozmiar");
+static_assert(sizeof(IndexHeader) == 128, "Nagwek indeksu musi mie stay rozmiar");
+
+static const uint16_t INDEX_BYTE_ORDER_MARK = 0x0102; ///< Znacznik kolejnoci bajtw zapisywany natywnie.
+static const uint64_t SECTION_ALIGNMENT = 64; ///< Wyrwnanie pocztku kadej sekcji pliku.
+
+/// \brief Zaokrgla przesunicie w gr do wyrwnania sekcji.
+static uint64_t alignSection(uint64_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+/// \brief Dopisuje dane sekcji, uzupeniajc plik zerami do jej przesunicia.
+static void writeSection(std::ofstream& out, uint64_t& position, uint64_t offset, const void* data, uint64_t size) {
+    static const char zeros[SECTION_ALIGNMENT] = {};
+    out.write(zeros, static_cast<std::streamsize>(offset - position));
+    if (size > 0) {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+    position = offset + size;
+}
+
+/// \brief Tworzy rekord na podstawie statystyki okresu.
+/// \param start Pocztek okresu (minuty od 01.01.1970).
+/// \param stats Statystyka okresu.
+RollupRecord RollupRecord::fromAggregate(int32_t start, const Aggregate& stats) {
+    RollupRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.start = start;
+    record.count = stats.count;
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        record.sum[channel] = stats.sum[channel];
+        record.sumSquares[channel] = stats.sumSquares[channel];
+        record.min[channel] = stats.min[channel];
+        record.max[channel] = stats.max[channel];
+    }
+    return record;
+}
+
+/// \brief Odtwarza statystyk okresu zapisan w rekordzie.
+Aggregate RollupRecord::toAggregate() const {
+    Aggregate stats;
+    stats.count = static_cast<size_t>(count);
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        stats.sum[channel] = sum[channel];
+        stats.sumSquares[channel] = sumSquares[channel];
+        stats.min[channel] = min[channel];
+        stats.max[channel] = max[channel];
+    }
+    return stats;
+}
+
+/// \brief Podmienia plik docelowy plikiem tymczasowym w jednym kroku.
+/// \return true, jeli podmiana si powioda.
+/// \details Plik docelowy nie jest wczeniej usuwany, wic w adnej chwili nie brakuje indeksu, a jeli podmiana
+/// si nie uda, stary indeks pozostaje nietknity. W systemie Windows rename nie nadpisuje istniejcego pliku,
+/// dlatego uywane jest MoveFileExA z flag MOVEFILE_REPLACE_EXISTING. Podmiana nie powiedzie si tam, dopki
+/// ktrykolwiek proces ma stary plik odwzorowany w pamici (TreeData::saveIndex zwalnia wasne odwzorowanie).
+static bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+/// \brief Zapisuje plik indeksu.
+/// \details Kolumny i sumy prefiksowe s zapisywane hurtowo, bez przetwarzania wierszy.
+void IndexFile::write(const std::string& path, const ColumnStore& store, const PrefixSumIndex& prefixSums,
+    const std::vector<RollupRecord>& quarters, const std::vector<RollupRecord>& days,
+    const std::vector<RollupRecord>& months) {
+    IndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "P6IX", 4);
+    header.version = VERSION;
+    header.byteOrder = INDEX_BYTE_ORDER_MARK;
+    header.channelCount = CHANNEL_COUNT;
+    header.rowCount = store.size();
+    header.quarterCount = quarters.size();
+    header.dayCount = days.size();
+    header.monthCount = months.size();
+
+    uint64_t rows = header.rowCount;
+    header.timestampsOffset = alignSection(sizeof(IndexHeader));
+    header.valuesOffset = alignSection(header.timestampsOffset + rows * sizeof(int32_t));
+    header.prefixOffset = alignSection(header.valuesOffset + CHANNEL_COUNT * rows * sizeof(float));
+    header.quartersOffset = alignSection(header.prefixOffset + CHANNEL_COUNT * (rows + 1) * sizeof(double));
+    header.daysOffset = alignSection(header.quartersOffset + quarters.size() * sizeof(RollupRecord));
+    header.monthsOffset = alignSection(header.daysOffset + days.size() * sizeof(RollupRecord));
+    header.fileSize = header.monthsOffset + months.size() * sizeof(RollupRecord);
+    header.headerCrc = Snapshot::crc32(&header, sizeof(header));
+    if (rows > 0 && prefixSums.length() != rows + 1) {
+        throw std::runtime_error("Sumy prefiksowe nie odpowiadaj magazynowi");
+    }
+
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Nie mona utworzy pliku indeksu: " + temporaryPath);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t position = sizeof(header);
+
+        writeSection(out, position, header.timestampsOffset, store.timestamps(), rows * sizeof(int32_t));
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            writeSection(out, position, header.valuesOffset + channel * rows * sizeof(float),
+                store.column(static_cast<Channel>(channel)), rows * sizeof(float));
+        }
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            const double zero = 0.0;  ///< Pusty magazyn ma jedn sum prefiksow rwn 0
+            const double* prefix = rows > 0 ? prefixSums.data(static_cast<Channel>(channel)) : &zero;
+            writeSection(out, position, header.prefixOffset + channel * (rows + 1) * sizeof(double),
+                prefix, (rows + 1) * sizeof(double));
+        }
+        writeSection(out, position, header.quartersOffset, quarters.data(), quarters.size() * sizeof(RollupRecord));
+        writeSection(out, position, header.daysOffset, days.data(), days.size() * sizeof(RollupRecord));
+        writeSection(out, position, header.monthsOffset, months.data(), months.size() * sizeof(RollupRecord));
+
+        out.close();
+        if (!out) {
+            std::remove(temporaryPath.c_str());
+            throw std::runtime_error("Nie mona zapisa pliku indeksu: " + temporaryPath);
+        }
+    }
+
+    if (!replaceFile(temporaryPath, path)) {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("Nie mona podmieni pliku indeksu: " + path);
+    }
+}
+
+/// \brief Odwzorowuje plik indeksu w pamici.
+/// \details Sprawdzany jest tylko nagwek i granice sekcji - zawarto kolumn nie jest czytana, dziki czemu
+/// otwarcie nie zaley od rozmiaru danych.
+bool IndexFile::open(const std::string& path) {
+    header = nullptr;
+    if (!file.open(path, MappedFile::Access::Random)) {
+        return false;
+    }
+    if (file.size() < sizeof(IndexHeader)) {
+        file.close();
+        throw std::runtime_error("Plik nie jest indeksem danych");
+    }
+
+    IndexHeader copy;
+    std::memcpy(&copy, file.data(), sizeof(copy));
+    if (std::memcmp(copy.magic, "P6IX", 4) != 0) {
+        file.close();
+        throw std::runtime_error("Plik nie jest indeksem danych");
+    }
+    if (copy.byteOrder != INDEX_BYTE_ORDER_MARK) {
+        file.close();
+        throw std::runtime_error("Indeks zapisany z inn kolejnoci bajtw");
+    }
+    if (copy.version != VERSION || copy.channelCount != CHANNEL_COUNT) {
+        file.close();
+        throw std::runtime_error("Nieobsugiwana wersja indeksu");
+    }
+    uint32_t headerCrc = copy.headerCrc;
+    copy.headerCrc = 0;
+    if (headerCrc != Snapshot::crc32(&copy, sizeof(copy))) {
+        file.close();
+        throw std::runtime_error("Niezgodna suma kontrolna nagwka indeksu");
+    }
+
+    uint64_t rows = copy.rowCount;
+    bool consistent = copy.fileSize == file.size() &&
+        copy.timestampsOffset >= sizeof(IndexHeader) &&
+        copy.valuesOffset >= copy.timestampsOffset + rows * sizeof(int32_t) &&
+        copy.prefixOffset >= copy.valuesOffset + CHANNEL_COUNT * rows * sizeof(float) &&
+        copy.quartersOffset >= copy.prefixOffset + CHANNEL_COUNT * (rows + 1) * sizeof(double) &&
+        copy.daysOffset >= copy.quartersOffset + copy.quarterCount * sizeof(RollupRecord) &&
+        copy.monthsOffset >= copy.daysOffset + copy.dayCount * sizeof(RollupRecord) &&
+        copy.fileSize >= copy.monthsOffset + copy.monthCount * sizeof(RollupRecord);
+    if (!consistent) {
+        file.close();
+        throw std::runtime_error("Niespjny ukad sekcji indeksu");
+    }
+
+    header = reinterpret_cast<const IndexHeader*>(file.data());
+    return true;
+}
@@ -0,0 +1,134 @@
+/// \file IndexFile.h
+/// \brief Deklaracja klasy IndexFile - pliku indeksu danych odwzorowywanego w pamici.
+
+#ifndef INDEXFILE_H
+#define INDEXFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h" ///< Odwzorowanie pliku w pamici.
+#include "ColumnStore.h" ///< Kolumnowy magazyn wierszy zapisywany w indeksie.
+#include "PrefixSumIndex.h" ///< Sumy prefiksowe zapisywane w indeksie.
+#include "Aggregate.h" ///< Statystyki zbiorcze okresw kalendarza.
+
+/// \struct RollupRecord
+/// \brief Statystyki zbiorcze jednego okresu kalendarza (kwartau dnia, dnia lub miesica) o staym ukadzie 136 bajtw.
+struct RollupRecord {
+    int32_t start; ///< Pocztek okresu (minuty od 01.01.1970).
+    uint32_t reserved; ///< Pole zarezerwowane, zawsze 0.
+    uint64_t count; ///< Liczba wierszy w okresie.
+    double sum[CHANNEL_COUNT]; ///< Sumy kanaw.
+    double sumSquares[CHANNEL_COUNT]; ///< Sumy kwadratw wartoci kanaw.
+    float min[CHANNEL_COUNT]; ///< Minimalne wartoci kanaw.
+    float max[CHANNEL_COUNT]; ///< Maksymalne wartoci kanaw.
+
+    /// \brief Tworzy rekord na podstawie statystyki okresu.
+    static RollupRecord fromAggregate(int32_t start, const Aggregate& stats);
+
+    /// \brief Odtwarza statystyk okresu zapisan w rekordzie.
+    Aggregate toAggregate() const;
+};
+
+/// \struct IndexHeader
+/// \brief Nagwek pliku indeksu o staym rozmiarze 128 bajtw.
+/// Przesunicia sekcji liczone s od pocztku pliku i wyrwnane do 64 bajtw.
+struct IndexHeader {
+    char magic[4]; ///< Sygnatura pliku "P6IX".
+    uint16_t version; ///< Wersja formatu.
+    uint16_t byteOrder; ///< Znacznik kolejnoci bajtw (0x0102 zapisane natywnie).
+    uint32_t channelCount; ///< Liczba kolumn wartoci (CHANNEL_COUNT).
+    uint32_t headerCrc; ///< CRC32 nagwka liczone przy headerCrc = 0.
+    uint64_t rowCount; ///< Liczba wierszy.
+    uint64_t quarterCount; ///< Liczba rekordw kwartaw dnia.
+    uint64_t dayCount; ///< Liczba rekordw dni.
+    uint64_t monthCount; ///< Liczba rekordw miesicy.
+    uint64_t timestampsOffset; ///< Przesunicie kolumny znacznikw czasu.
+    uint64_t valuesOffset; ///< Przesunicie kolumn wartoci (kolejno wszystkie kanay).
+    uint64_t prefixOffset; ///< Przesunicie sum prefiksowych (kolejno wszystkie kanay, rowCount + 1 elementw).
+    uint64_t quartersOffset; ///< Przesunicie rekordw kwartaw dnia.
+    uint64_t daysOffset; ///< Przesunicie rekordw dni.
+    uint64_t monthsOffset; ///< Przesunicie rekordw miesicy.
+    uint64_t fileSize; ///< Cakowity rozmiar pliku.
+    uint64_t reserved[3]; ///< Pola zarezerwowane, zawsze 0.
+};
+
+/// \class IndexFile
+/// \brief Trway, tylko do odczytu ukad danych, ktry TreeData odwzorowuje w pamici bez deserializacji.
+/// Plik zawiera posortowan kolumn znacznikw czasu, kolumny wartoci, sumy prefiksowe kanaw oraz statystyki
+/// zbiorcze kwartaw dnia, dni i miesicy. Otwarcie sprawdza wycznie nagwek, wic jego koszt nie zaley
+/// od liczby wierszy, a strony pliku s wczytywane dopiero przy pierwszym dostpie i wspdzielone w pamici
+/// podrcznej systemu przez wszystkie procesy, ktre odwzoroway ten sam plik.
+class IndexFile {
+public:
+    static const uint16_t VERSION = 2; ///< Bieca wersja formatu (2: sumy kwadratw w RollupRecord).
+
+    /// \brief Zapisuje plik indeksu.
+    /// \param path cieka do pliku.
+    /// \param store Magazyn kolumnowy.
+    /// \param prefixSums Sumy prefiksowe odpowiadajce magazynowi.
+    /// \param quarters Statystyki kwartaw dnia, posortowane wedug pocztku okresu.
+    /// \param days Statystyki dni, posortowane wedug pocztku okresu.
+    /// \param months Statystyki miesicy, posortowane wedug pocztku okresu.
+    /// \throws std::runtime_error Gdy zapis si nie powiedzie.
+    /// \details Plik jest zapisywany pod nazw tymczasow i dopiero potem podmieniany, wic nigdy nie jest widoczny
+    /// w poowie zapisu. W systemach POSIX procesy, ktre odwzoroway poprzedni wersj, nadal widz spjne dane;
+    /// w systemie Windows podmiana odwzorowanego pliku si nie udaje - zgaszany jest wtedy wyjtek, a poprzednia
+    /// wersja pozostaje bez zmian.
+    static void write(const std::string& path, const ColumnStore& store, const PrefixSumIndex& prefixSums,
+        const std::vector<RollupRecord>& quarters, const std::vector<RollupRecord>& days,
+        const std::vector<RollupRecord>& months);
+
+    /// \brief Odwzorowuje plik indeksu w pamici.
+    /// \param path cieka do pliku.
+    /// \return true, jeli plik istnieje i zosta odwzorowany; false, jeli nie mona go otworzy.
+    /// \throws std::runtime_error Gdy plik nie jest indeksem, ma inn wersj, kolejno bajtw lub bdny nagwek.
+    bool open(const std::string& path);
+
+    /// \brief Zwraca liczb wierszy.
+    size_t rowCount() const { return static_cast<size_t>(header->rowCount); }
+
+    /// \brief Zwraca wskanik na kolumn znacznikw czasu.
+    const int32_t* timestamps() const { return section<int32_t>(header->timestampsOffset); }
+
+    /// \brief Zwraca wskanik na kolumn wartoci kanau.
+    const float* column(Channel channel) const {
+        return section<float>(header->valuesOffset) + static_cast<size_t>(channel) * rowCount();
+    }
+
+    /// \brief Zwraca wskanik na sumy prefiksowe kanau (rowCount() + 1 elementw).
+    const double* prefixSums(Channel channel) const {
+        return section<double>(header->prefixOffset) + static_cast<size_t>(channel) * (rowCount() + 1);
+    }
+
+    /// \brief Zwraca rekordy kwartaw dnia.
+    const RollupRecord* quarters() const { return section<RollupRecord>(header->quartersOffset); }
+
+    /// \brief Zwraca liczb rekordw kwartaw dnia.
+    size_t quarterCount() const { return static_cast<size_t>(header->quarterCount); }
+
+    /// \brief Zwraca rekordy dni.
+    const RollupRecord* days() const { return section<RollupRecord>(header->daysOffset); }
+
+    /// \brief Zwraca liczb rekordw dni.
+    size_t dayCount() const { return static_cast<size_t>(header->dayCount); }
+
+    /// \brief Zwraca rekordy miesicy.
+    const RollupRecord* months() const { return section<RollupRecord>(header->monthsOffset); }
+
+    /// \brief Zwraca liczb rekordw miesicy.
+    size_t monthCount() const { return static_cast<size_t>(header->monthCount); }
+
+private:
+    /// \brief Zwraca wskanik na sekcj pliku o podanym przesuniciu.
+    template <typename T>
+    const T* section(uint64_t offset) const {
+        return reinterpret_cast<const T*>(file.data() + offset);
+    }
+
+    MappedFile file; ///< Odwzorowany plik indeksu.
+    const IndexHeader* header = nullptr; ///< Nagwek w odwzorowanej pamici.
+};
+
+#endif // INDEXFILE_H
@@ -14,7 +14,8 @@
 /// \param line Wiersz danych wejściowych.
 /// \return true, jeśli wiersz jest poprawny, false w przeciwnym razie.
 /// Funkcja ta waliduje wiersz CSV poprzez sprawdzenie jego zawartości, takich jak liczba parametrów oraz obecność niepożądanych liter.
-bool lineValidation(const std::string& line)
+/// Jest zadeklarowana jako inline, ponieważ korzysta z niej również CsvParser do logowania odrzuconych wierszy.
+inline bool lineValidation(const std::string& line)
 {
     // Sprawdzenie, czy wiersz jest pusty.
     if (line.empty())
@@ -2,6 +2,7 @@
 /// \brief Implementacja klasy LogManager do obsugi logowania komunikatw.
 
 #include "LogManager.h"
+#include <chrono>
 #include <iomanip>
 #include <ctime>
 #include <cstdio>
@@ -20,7 +21,7 @@ LogManager errorLogger("log_error");
 /// \var errorLogCount
 /// \brief Licznik wystpie bdw logowanych przez errorLogger.
 /// Licznik jest zwikszany za kadym razem, gdy loggerError zapisuje komunikat bdu.
-int errorLogCount = 0;
+std::atomic<int> errorLogCount(0);
 
 
 /// \brief Konstruktor klasy LogManager.
@@ -33,7 +34,7 @@ LogManager::LogManager(const std::string& filename) {
     localtime_s(&tm, &t); ///< Konwersja czasu na lokalny format.
     std::ostringstream oss; ///< Strumie do tworzenia acucha tekstowego z nazw pliku.
     oss << filename << "_" << std::put_time(&tm, "%d%m%Y_%H%M%S") << ".txt"; ///< Budowanie penej nazwy pliku.
-    std::string datedFilename = oss.str(); ///< Nazwa pliku z dat i godzin.
+    datedFilename = oss.str(); ///< Nazwa pliku z dat i godzin.
 
     // Usuwanie istniejcego pliku logu, jeli ju istnieje.
     if (std::remove(datedFilename.c_str()) != 0) {
@@ -49,6 +50,7 @@ LogManager::LogManager(const std::string& filename) {
 /// \brief Destruktor klasy LogManager.
 /// \details Zamyka otwarty plik logu, zapewniajc, e wszystkie dane zostay zapisane.
 LogManager::~LogManager() {
+    stopAsync(); ///< Zapisanie komunikatw oczekujcych w buforze.
     if (logFile.is_open()) {
         logFile.close(); ///< Zamknicie strumienia pliku logu.
     }
@@ -56,17 +58,170 @@ LogManager::~LogManager() {
 
 /// \brief Zapisuje komunikat do pliku logu.
 /// \param message Komunikat do zapisania w pliku logu.
-/// Funkcja zapisuje podany komunikat do pliku logu wraz z biec dat i godzin.
+/// Funkcja zapisuje podany komunikat do pliku logu wraz z biec dat i godzin. W trybie asynchronicznym
+/// komunikat jest jedynie kopiowany do bufora piercieniowego, a dat formatuje wtek piszcy.
 void LogManager::log(const std::string& message) {
+    // Zwikszanie licznika bdw, jeli logowany komunikat pochodzi z errorLogger (take gdy zostanie odrzucony).
+    if (this == &errorLogger) {
+        ++errorLogCount;
+    }
+
+    if (asyncMode.load(std::memory_order_acquire)) {
+        std::time_t t = std::time(nullptr); ///< Czas zalogowania - formatowany dopiero w wtku piszcym.
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[pos & mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (difference == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;  ///< Miejsce zajte przez ten wtek
+                }
+            }
+            else if (difference < 0) {
+                // Bufor peny
+                if (overflowPolicy == OverflowPolicy::Drop) {
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                wakeCondition.notify_one();
+                std::this_thread::yield();
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+            else {
+                pos = enqueuePos.load(std::memory_order_relaxed);  ///< Inny producent zaj to miejsce
+            }
+        }
+        slot->time = t;
+        slot->message = message;  ///< Kopia do napisu o ju zarezerwowanej pojemnoci
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        if (writerSleeping.load(std::memory_order_relaxed)) {
+            wakeCondition.notify_one();
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(logMutex); ///< Zapis do pliku tylko z jednego wtku naraz.
     if (logFile.is_open()) {
         auto t = std::time(nullptr); ///< Pobranie biecego czasu.
         std::tm tm; ///< Struktura przechowujca czas w formacie lokalnym.
         localtime_s(&tm, &t); ///< Konwersja czasu na lokalny format.
         logFile << std::put_time(&tm, "%d.%m.%Y %H:%M:%S") << " " << message << std::endl; ///< Zapisanie komunikatu z dat i godzin.
     }
+}
+
+/// \brief Zapisuje komunikat o podanym poziomie, jeli poziom nie jest niszy od progu logowania.
+/// \param level Poziom komunikatu.
+/// \param message Komunikat do zapisania w pliku logu.
+void LogManager::log(LogLevel level, const std::string& message) {
+    if (isEnabled(level)) {
+        log(message);
+    }
+}
 
-    // Zwikszanie licznika bdw, jeli logowany komunikat pochodzi z errorLogger.
-    if (this == &errorLogger) {
-        ++errorLogCount;
+/// \brief Wcza tryb asynchroniczny z wtkiem piszcym w tle.
+/// \param capacity Pojemno bufora piercieniowego (zaokrglana w gr do potgi dwjki).
+/// \param policy Zachowanie przy penym buforze.
+void LogManager::startAsync(size_t capacity, OverflowPolicy policy) {
+    stopAsync();
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    slots.reset(new Slot[size]);
+    for (size_t i = 0; i < size; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask = size - 1;
+    overflowPolicy = policy;
+    enqueuePos.store(0, std::memory_order_relaxed);
+    dequeuePos = 0;
+    writtenPos.store(0, std::memory_order_relaxed);
+    stopping.store(false, std::memory_order_relaxed);
+    writer = std::thread(&LogManager::writerLoop, this);
+    asyncMode.store(true, std::memory_order_release);
+}
+
+/// \brief Zapisuje wszystkie oczekujce komunikaty, zatrzymuje wtek piszcy i wraca do trybu synchronicznego.
+void LogManager::stopAsync() {
+    if (!writer.joinable()) {
+        return;
+    }
+    asyncMode.store(false, std::memory_order_release);
+    stopping.store(true, std::memory_order_release);
+    wakeCondition.notify_one();
+    writer.join();
+    slots.reset();
+}
+
+/// \brief Czeka, a wszystkie komunikaty zalogowane przed wywoaniem zostan zapisane do pliku.
+void LogManager::flush() {
+    if (!asyncMode.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(logMutex);
+        logFile.flush();
+        return;
+    }
+    size_t target = enqueuePos.load(std::memory_order_acquire);
+    while (writtenPos.load(std::memory_order_acquire) < target) {
+        wakeCondition.notify_one();
+        std::this_thread::yield();
+    }
+}
+
+/// \brief Przenosi gotowe komunikaty z bufora do paczki tekstu.
+/// \param[out] batch Paczka, do ktrej dopisywane s sformatowane wiersze.
+/// \return Liczba przeniesionych komunikatw.
+/// \details Data jest formatowana tylko wtedy, gdy zmieni si sekunda, wic koszt localtime_s rozkada si
+/// na wszystkie komunikaty z tej samej sekundy.
+size_t LogManager::drain(std::string& batch) {
+    static thread_local std::time_t formattedTime = -1;
+    static thread_local char prefix[32];
+    size_t count = 0;
+    while (count <= mask) {
+        Slot& slot = slots[dequeuePos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            break;  ///< Brak kolejnego opublikowanego komunikatu
+        }
+        if (slot.time != formattedTime) {
+            std::tm tm;
+            localtime_s(&tm, &slot.time);
+            std::strftime(prefix, sizeof(prefix), "%d.%m.%Y %H:%M:%S ", &tm);
+            formattedTime = slot.time;
+        }
+        batch += prefix;
+        batch += slot.message;
+        batch += '\n';
+        slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);  ///< Zwolnienie miejsca
+        ++dequeuePos;
+        ++count;
+    }
+    return count;
+}
+
+/// \brief Ptla wtku piszcego: oprnia bufor paczkami a do zatrzymania.
+/// \details Kada paczka jest zapisywana jednym wywoaniem write. Gdy bufor jest pusty, wtek usypia na krtko
+/// lub do czasu obudzenia przez producenta. Przed zakoczeniem zapisywane s wszystkie pozostae komunikaty.
+void LogManager::writerLoop() {
+    std::string batch;
+    for (;;) {
+        if (drain(batch) > 0) {
+            logFile.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            logFile.flush();
+            batch.clear();
+            writtenPos.store(dequeuePos, std::memory_order_release);
+            continue;
+        }
+        if (stopping.load(std::memory_order_acquire)) {
+            if (dequeuePos == enqueuePos.load(std::memory_order_acquire)) {
+                break;
+            }
+            std::this_thread::yield();  ///< Producent zarezerwowa miejsce, ale jeszcze go nie wypeni
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerSleeping.store(true, std::memory_order_relaxed);
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(2));
+        writerSleeping.store(false, std::memory_order_relaxed);
     }
 }
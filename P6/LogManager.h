@@ -4,13 +4,52 @@
 #ifndef LOGMANAGER_H
 #define LOGMANAGER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+
+/// \enum LogLevel
+/// \brief Poziom wanoci komunikatu, od najmniej do najbardziej istotnego.
+enum class LogLevel {
+    Trace = 0, ///< Szczegy pojedynczych operacji (np. kady wczytany wiersz).
+    Debug = 1, ///< Informacje diagnostyczne.
+    Info = 2, ///< Zwyke komunikaty informacyjne.
+    Warn = 3, ///< Ostrzeenia.
+    Error = 4 ///< Bdy. Ten poziom nigdy nie jest usuwany podczas kompilacji.
+};
+
+/// \def P6_LOG_MIN_LEVEL
+/// \brief Najniszy poziom (warto LogLevel), dla ktrego wywoania makr logowania s kompilowane.
+/// Domylnie 0 (Trace) w kompilacji debug i 2 (Info) w kompilacji z NDEBUG; mona go nadpisa opcj kompilatora.
+#ifndef P6_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define P6_LOG_MIN_LEVEL 2
+#else
+#define P6_LOG_MIN_LEVEL 0
+#endif
+#endif
 
 /// \class LogManager
 /// \brief Klasa obsugujca logowanie komunikatw do plikw tekstowych.
+/// Domylnie kady komunikat jest zapisywany do pliku od razu, w wywoujcym wtku. Po wywoaniu startAsync()
+/// komunikaty trafiaj do ograniczonego bufora piercieniowego (wielu producentw, jeden konsument, bez blokad),
+/// a wtek piszcy formatuje dat i zapisuje je do pliku paczkami, jednym wywoaniem write na paczk.
 class LogManager {
 public:
+    /// \enum OverflowPolicy
+    /// \brief Zachowanie log() w trybie asynchronicznym, gdy bufor piercieniowy jest peny.
+    enum class OverflowPolicy {
+        Block, ///< Wywoujcy czeka, a wtek piszcy zwolni miejsce - aden komunikat nie ginie.
+        Drop ///< Komunikat jest odrzucany i zliczany (getDroppedCount()).
+    };
+
     /// \brief Konstruktor klasy LogManager.
     /// \details Tworzy plik logu z unikaln nazw opart na aktualnej dacie i godzinie.
     /// \param filename Nazwa podstawowa pliku logu, ktra bdzie uyta do stworzenia penej nazwy pliku.
@@ -23,13 +62,130 @@ public:
 
     /// \brief Zapisuje komunikat do pliku logu.
     /// \param message Komunikat do zapisania w pliku logu.
-    /// Funkcja ta zapisuje podany komunikat do otwartego pliku logu.
+    /// Funkcja ta zapisuje podany komunikat do otwartego pliku logu. Moe by wywoywana rwnolegle z wielu wtkw.
+    /// W trybie asynchronicznym jedynie kopiuje komunikat i czas do wolnego miejsca w buforze piercieniowym.
     void log(const std::string& message);
 
+    /// \brief Zapisuje komunikat o podanym poziomie, jeli poziom nie jest niszy od progu logowania.
+    /// \param level Poziom komunikatu.
+    /// \param message Komunikat do zapisania w pliku logu.
+    /// \details Komunikat jest ju zbudowany w chwili wywoania - aby pomin jego formatowanie, naley uywa
+    /// makr P6_LOG_TRACE ... P6_LOG_ERROR.
+    void log(LogLevel level, const std::string& message);
+
+    /// \brief Ustawia prg logowania w czasie dziaania programu.
+    /// \param level Najniszy poziom zapisywanych komunikatw.
+    void setLevel(LogLevel level) { minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+
+    /// \brief Zwraca biecy prg logowania.
+    LogLevel getLevel() const { return static_cast<LogLevel>(minimumLevel.load(std::memory_order_relaxed)); }
+
+    /// \brief Sprawdza, czy komunikaty o podanym poziomie s zapisywane.
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= minimumLevel.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Wcza tryb asynchroniczny z wtkiem piszcym w tle.
+    /// \param capacity Pojemno bufora piercieniowego (zaokrglana w gr do potgi dwjki).
+    /// \param policy Zachowanie przy penym buforze.
+    /// \details Nie moe by wywoywana, gdy inne wtki loguj komunikaty.
+    void startAsync(size_t capacity = 8192, OverflowPolicy policy = OverflowPolicy::Block);
+
+    /// \brief Zapisuje wszystkie oczekujce komunikaty, zatrzymuje wtek piszcy i wraca do trybu synchronicznego.
+    /// \details Nie moe by wywoywana, gdy inne wtki loguj komunikaty. Wywoywana take przez destruktor.
+    void stopAsync();
+
+    /// \brief Czeka, a wszystkie komunikaty zalogowane przed wywoaniem zostan zapisane do pliku.
+    void flush();
+
+    /// \brief Zwraca liczb komunikatw odrzuconych przy penym buforze (polityka Drop).
+    uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+
+    /// \brief Zwraca nazw pliku logu (z dat i godzin).
+    const std::string& getFileName() const { return datedFilename; }
+
 private:
+    /// \struct Slot
+    /// \brief Miejsce w buforze piercieniowym; numer sekwencji mwi, czy jest wolne, czy zawiera komunikat.
+    struct Slot {
+        std::atomic<size_t> sequence; ///< Numer sekwencji miejsca (algorytm ograniczonej kolejki D. Vyukova).
+        std::time_t time; ///< Czas zalogowania komunikatu.
+        std::string message; ///< Tre komunikatu; pojemno napisu jest ponownie uywana.
+    };
+
+    /// \brief Ptla wtku piszcego: oprnia bufor paczkami a do zatrzymania.
+    void writerLoop();
+
+    /// \brief Przenosi gotowe komunikaty z bufora do paczki tekstu.
+    /// \param[out] batch Paczka, do ktrej dopisywane s sformatowane wiersze.
+    /// \return Liczba przeniesionych komunikatw.
+    size_t drain(std::string& batch);
+
+    std::string datedFilename; ///< Nazwa pliku logu z dat i godzin.
     std::ofstream logFile; ///< Strumie pliku logu, uywany do zapisywania komunikatw.
+    std::mutex logMutex; ///< Muteks chronicy plik logu przed rwnoczesnym zapisem z wielu wtkw.
+    std::atomic<int> minimumLevel{ static_cast<int>(LogLevel::Trace) }; ///< Prg logowania w czasie dziaania.
+
+    std::unique_ptr<Slot[]> slots; ///< Bufor piercieniowy trybu asynchronicznego.
+    size_t mask = 0; ///< Pojemno bufora minus 1.
+    OverflowPolicy overflowPolicy = OverflowPolicy::Block; ///< Zachowanie przy penym buforze.
+    std::atomic<bool> asyncMode{ false }; ///< Informacja, czy dziaa wtek piszcy.
+    std::atomic<size_t> enqueuePos{ 0 }; ///< Nastpna pozycja zapisu producentw.
+    size_t dequeuePos = 0; ///< Nastpna pozycja odczytu (uywana tylko przez wtek piszcy).
+    std::atomic<size_t> writtenPos{ 0 }; ///< Liczba komunikatw zapisanych ju do pliku.
+    std::atomic<uint64_t> droppedCount{ 0 }; ///< Liczba odrzuconych komunikatw.
+    std::atomic<bool> stopping{ false }; ///< danie zatrzymania wtku piszcego.
+    std::atomic<bool> writerSleeping{ false }; ///< Informacja, czy wtek piszcy czeka na komunikaty.
+    std::mutex wakeMutex; ///< Muteks zmiennej warunkowej wtku piszcego.
+    std::condition_variable wakeCondition; ///< Budzi wtek piszcy po pojawieniu si komunikatw.
+    std::thread writer; ///< Wtek piszcy.
 };
 
+/// \def P6_LOG_AT
+/// \brief Loguje komunikat, obliczajc wyraenie message tylko wtedy, gdy poziom przekracza prg logowania.
+#define P6_LOG_AT(logger, level, message) \
+    do { \
+        if ((logger).isEnabled(level)) { \
+            (logger).log(message); \
+        } \
+    } while (0)
+
+/// \def P6_LOG_TRACE
+/// \brief Loguje komunikat poziomu Trace; poniej P6_LOG_MIN_LEVEL wywoanie (wraz z argumentami) nie jest kompilowane.
+#if P6_LOG_MIN_LEVEL <= 0
+#define P6_LOG_TRACE(logger, message) P6_LOG_AT(logger, LogLevel::Trace, message)
+#else
+#define P6_LOG_TRACE(logger, message) ((void)0)
+#endif
+
+/// \def P6_LOG_DEBUG
+/// \brief Loguje komunikat poziomu Debug; poniej P6_LOG_MIN_LEVEL wywoanie nie jest kompilowane.
+#if P6_LOG_MIN_LEVEL <= 1
+#define P6_LOG_DEBUG(logger, message) P6_LOG_AT(logger, LogLevel::Debug, message)
+#else
+#define P6_LOG_DEBUG(logger, message) ((void)0)
+#endif
+
+/// \def P6_LOG_INFO
+/// \brief Loguje komunikat poziomu Info; poniej P6_LOG_MIN_LEVEL wywoanie nie jest kompilowane.
+#if P6_LOG_MIN_LEVEL <= 2
+#define P6_LOG_INFO(logger, message) P6_LOG_AT(logger, LogLevel::Info, message)
+#else
+#define P6_LOG_INFO(logger, message) ((void)0)
+#endif
+
+/// \def P6_LOG_WARN
+/// \brief Loguje komunikat poziomu Warn; poniej P6_LOG_MIN_LEVEL wywoanie nie jest kompilowane.
+#if P6_LOG_MIN_LEVEL <= 3
+#define P6_LOG_WARN(logger, message) P6_LOG_AT(logger, LogLevel::Warn, message)
+#else
+#define P6_LOG_WARN(logger, message) ((void)0)
+#endif
+
+/// \def P6_LOG_ERROR
+/// \brief Loguje komunikat poziomu Error. Bdy s zawsze kompilowane, aby licznik errorLogCount by kompletny.
+#define P6_LOG_ERROR(logger, message) P6_LOG_AT(logger, LogLevel::Error, message)
+
 /// \var globalLogger
 /// \brief Globalny logger dla standardowych komunikatw.
 /// Logger ten jest uywany do zapisywania komunikatw informacyjnych oraz standardowych.
@@ -44,7 +200,8 @@ extern LogManager errorLogger;
 
 /// \var errorLogCount
 /// \brief Licznik wystpie bdw logowanych przez errorLogger.
-/// Zmienna ta przechowuje liczb bdw zarejestrowanych przez errorLogger.
-extern int errorLogCount;
+/// Zmienna ta przechowuje liczb bdw zarejestrowanych przez errorLogger. Jest atomowa, poniewa bdy
+/// mog by logowane rwnolegle przez wtki wczytujce plik CSV.
+extern std::atomic<int> errorLogCount;
 
 #endif // LOGMANAGER_H
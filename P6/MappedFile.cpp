@@ -0,0 +1,135 @@
+/// \file MappedFile.cpp
+/// \brief Implementacja klasy MappedFile - pliku odwzorowanego w pamici tylko do odczytu.
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// \brief Tworzy pusty obiekt, niezwizany z adnym plikiem.
+MappedFile::MappedFile() : view(nullptr), length(0), opened(false),
+#ifdef _WIN32
+    fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr)
+#else
+    descriptor(-1)
+#endif
+{
+}
+
+/// \brief Destruktor klasy MappedFile.
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+/// \brief Otwiera plik i odwzorowuje go w pamici (Windows).
+/// \details Plik otwierany jest z flag FILE_FLAG_SEQUENTIAL_SCAN lub FILE_FLAG_RANDOM_ACCESS, zalenie od
+/// spodziewanego sposobu odczytu.
+bool MappedFile::open(const std::string& path, Access access) {
+    close();
+    DWORD accessFlag = access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | accessFlag, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (GetFileType(fileHandle) != FILE_TYPE_DISK || !GetFileSizeEx(fileHandle, &fileSize)) {
+        close();  ///< Potoki i urzdzenia nie mog zosta odwzorowane
+        return false;
+    }
+
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length > 0) {
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr) {
+            close();
+            return false;
+        }
+        view = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (view == nullptr) {
+            close();
+            return false;
+        }
+    }
+    opened = true;
+    return true;
+}
+
+/// \brief Usuwa odwzorowanie i zamyka plik (Windows).
+void MappedFile::close() {
+    if (view != nullptr) {
+        UnmapViewOfFile(view);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+    }
+    view = nullptr;
+    length = 0;
+    opened = false;
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = nullptr;
+}
+
+#else
+
+/// \brief Otwiera plik i odwzorowuje go w pamici (POSIX).
+/// \details Po odwzorowaniu jdro dostaje podpowied MADV_SEQUENTIAL, dziki czemu strony s wczytywane
+/// z wyprzedzeniem, a te ju przeczytane mog by szybko zwalniane. Dla odczytu swobodnego (MADV_RANDOM)
+/// wczytywane s tylko strony, ktrych dotyka zapytanie.
+bool MappedFile::open(const std::string& path, Access access) {
+    close();
+    descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode)) {
+        close();  ///< Potoki i urzdzenia nie mog zosta odwzorowane
+        return false;
+    }
+
+    length = static_cast<size_t>(status.st_size);
+    if (length > 0) {
+        void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED) {
+            close();
+            return false;
+        }
+        madvise(address, length, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+        view = static_cast<const char*>(address);
+    }
+    opened = true;
+    return true;
+}
+
+/// \brief Usuwa odwzorowanie i zamyka plik (POSIX).
+void MappedFile::close() {
+    if (view != nullptr) {
+        munmap(const_cast<char*>(view), length);
+    }
+    if (descriptor >= 0) {
+        ::close(descriptor);
+    }
+    view = nullptr;
+    length = 0;
+    opened = false;
+    descriptor = -1;
+}
+
+#endif
@@ -0,0 +1,66 @@
+/// \file MappedFile.h
+/// \brief Deklaracja klasy MappedFile - pliku odwzorowanego w pamici tylko do odczytu.
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/// \class MappedFile
+/// \brief Odwzorowuje zwyky plik w pamici (mmap / MapViewOfFile) w trybie tylko do odczytu.
+/// Zawarto pliku jest dostpna bezporednio jako tablica znakw, bez kopiowania do buforw programu.
+/// System jest informowany, e plik bdzie czytany sekwencyjnie, co pozwala na agresywny odczyt z wyprzedzeniem.
+/// Potoki i inne pliki specjalne nie mog zosta odwzorowane - wtedy open() zwraca false i naley uy
+/// zwykego odczytu strumieniowego.
+class MappedFile {
+public:
+    /// \enum Access
+    /// \brief Spodziewany sposb odczytu pliku, przekazywany systemowi jako podpowied.
+    enum class Access {
+        Sequential, ///< Jednokrotny odczyt od pocztku do koca (np. parsowanie CSV).
+        Random ///< Odczyt w dowolnych miejscach (np. plik indeksu przeszukiwany binarnie).
+    };
+
+    /// \brief Tworzy pusty obiekt, niezwizany z adnym plikiem.
+    MappedFile();
+
+    /// \brief Destruktor klasy MappedFile.
+    /// \details Usuwa odwzorowanie i zamyka plik.
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// \brief Otwiera plik i odwzorowuje go w pamici.
+    /// \param path cieka do pliku.
+    /// \param access Spodziewany sposb odczytu pliku.
+    /// \return true, jeli plik zosta odwzorowany, false jeli nie istnieje, nie jest zwykym plikiem
+    /// lub odwzorowanie si nie powiodo.
+    bool open(const std::string& path, Access access = Access::Sequential);
+
+    /// \brief Usuwa odwzorowanie i zamyka plik.
+    void close();
+
+    /// \brief Zwraca wskanik na pocztek zawartoci pliku.
+    const char* data() const { return view; }
+
+    /// \brief Zwraca rozmiar pliku w bajtach.
+    size_t size() const { return length; }
+
+    /// \brief Sprawdza, czy plik jest otwarty i odwzorowany.
+    bool isOpen() const { return opened; }
+
+private:
+    const char* view; ///< Pocztek odwzorowanej zawartoci pliku.
+    size_t length; ///< Rozmiar pliku w bajtach.
+    bool opened; ///< Informacja, czy plik zosta odwzorowany.
+#ifdef _WIN32
+    void* fileHandle; ///< Uchwyt pliku (HANDLE).
+    void* mappingHandle; ///< Uchwyt odwzorowania (HANDLE).
+#else
+    int descriptor; ///< Deskryptor pliku.
+#endif
+};
+
+#endif // MAPPEDFILE_H
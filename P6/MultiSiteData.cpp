@@ -0,0 +1,273 @@
+/// \file MultiSiteData.cpp
+/// \brief Implementacja wielu nazwanych serii pomiarowych na wsplnej osi czasu.
+
+#include "MultiSiteData.h"
+#include "CsvParser.h"
+#include "ThreadPool.h"
+#include "Timestamp.h"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+/// \brief Dodaje paczk wierszy wielu instalacji.
+/// \details Znaczniki czasu kadej instalacji s sortowane (tylko jeli wiersze nie s uporzdkowane) i scalane
+/// z osi czasu (std::set_union), wic instalacje raportujce w tym samym rytmie scalaj si w czasie liniowym.
+/// Jeli o si wyduya, kolumny istniejcych serii s przenoszone na nowe pozycje wedug jednej, wsplnej
+/// tablicy przejcia.
+void MultiSiteData::addSeries(const std::vector<SiteRows>& batch) {
+    std::vector<int32_t> merged = timeline;  ///< O czasu po dodaniu paczki
+    std::vector<int32_t> siteTimestamps, unionBuffer;
+    for (const auto& siteRows : batch) {
+        siteTimestamps.clear();
+        for (const auto& rowData : siteRows.rows) {
+            siteTimestamps.push_back(rowData.getTimestamp());
+        }
+        if (!std::is_sorted(siteTimestamps.begin(), siteTimestamps.end())) {
+            std::sort(siteTimestamps.begin(), siteTimestamps.end());
+        }
+        siteTimestamps.erase(std::unique(siteTimestamps.begin(), siteTimestamps.end()), siteTimestamps.end());
+        if (std::includes(merged.begin(), merged.end(), siteTimestamps.begin(), siteTimestamps.end())) {
+            continue;  ///< Instalacja nie wnosi nowych znacznikw czasu
+        }
+        unionBuffer.clear();
+        unionBuffer.reserve(merged.size() + siteTimestamps.size());
+        std::set_union(merged.begin(), merged.end(), siteTimestamps.begin(), siteTimestamps.end(),
+            std::back_inserter(unionBuffer));
+        merged.swap(unionBuffer);
+    }
+
+    if (merged.size() != timeline.size()) {
+        // Pozycja kadego dotychczasowego znacznika czasu na nowej osi
+        std::vector<size_t> newPosition(timeline.size());
+        for (size_t oldIndex = 0, newIndex = 0; oldIndex < timeline.size(); ++oldIndex) {
+            while (merged[newIndex] != timeline[oldIndex]) {
+                ++newIndex;
+            }
+            newPosition[oldIndex] = newIndex;
+        }
+
+        for (auto& siteSeries : series) {
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                std::vector<float> moved(merged.size(), 0.0f);
+                for (size_t oldIndex = 0; oldIndex < timeline.size(); ++oldIndex) {
+                    moved[newPosition[oldIndex]] = siteSeries.values[channel][oldIndex];
+                }
+                siteSeries.values[channel].swap(moved);
+            }
+            std::vector<uint64_t> movedPresent((merged.size() + 63) / 64, 0);
+            for (size_t oldIndex = 0; oldIndex < timeline.size(); ++oldIndex) {
+                if (siteSeries.has(oldIndex)) {
+                    movedPresent[newPosition[oldIndex] >> 6] |= uint64_t(1) << (newPosition[oldIndex] & 63);
+                }
+            }
+            siteSeries.present.swap(movedPresent);
+        }
+        timeline.swap(merged);
+    }
+
+    for (const auto& siteRows : batch) {
+        Series& siteSeries = seriesFor(siteRows.site);
+        size_t position = 0;
+        for (const auto& rowData : siteRows.rows) {
+            // Wiersze w kolejnoci chronologicznej zwykle trafiaj na pozycj tu za poprzedni
+            if (position >= timeline.size() || timeline[position] != rowData.getTimestamp()) {
+                position = std::lower_bound(timeline.begin(), timeline.end(), rowData.getTimestamp()) - timeline.begin();
+            }
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                siteSeries.values[channel][position] = rowData.getValue(static_cast<Channel>(channel));
+            }
+            if (!siteSeries.has(position)) {
+                siteSeries.present[position >> 6] |= uint64_t(1) << (position & 63);
+                ++siteSeries.readings;
+            }
+            ++position;
+        }
+    }
+}
+
+/// \brief Wczytuje pliki CSV wielu instalacji jako jedn paczk.
+size_t MultiSiteData::loadFiles(const std::vector<SiteFile>& files) {
+    std::vector<SiteRows> batch(files.size());
+    std::vector<char> opened(files.size(), 0);
+    ThreadPool::shared().parallelFor(files.size(), [&files, &batch, &opened](size_t fileIndex) {
+        CsvParser csvParser;  ///< Osobny parser dla kadego pliku
+        SiteRows& siteRows = batch[fileIndex];
+        siteRows.site = files[fileIndex].site;
+        opened[fileIndex] = csvParser.parseFile(files[fileIndex].path, [&siteRows](const RowData& rowData) {
+            siteRows.rows.push_back(rowData);
+        });
+    });
+
+    size_t rowCount = 0;
+    for (size_t fileIndex = 0; fileIndex < files.size(); ++fileIndex) {
+        if (!opened[fileIndex]) {
+            throw std::runtime_error("Nie mona otworzy pliku: " + files[fileIndex].path);
+        }
+        rowCount += batch[fileIndex].rows.size();
+    }
+    addSeries(batch);
+    return rowCount;
+}
+
+/// \brief Zwraca nazwy instalacji w kolejnoci ich dodania.
+std::vector<std::string> MultiSiteData::siteNames() const {
+    std::vector<std::string> names;
+    names.reserve(series.size());
+    for (const auto& siteSeries : series) {
+        names.push_back(siteSeries.name);
+    }
+    return names;
+}
+
+/// \brief Zwraca liczb odczytw instalacji.
+size_t MultiSiteData::readingCount(const std::string& site) const {
+    return resolveSites(SiteSet{ site }).front()->readings;
+}
+
+/// \brief Zwraca wiersze instalacji z przedziau czasowego.
+std::vector<RowData> MultiSiteData::getSiteDataBetweenDates(const std::string& site, const std::string& startDate,
+    const std::string& endDate) const {
+    const Series& siteSeries = *resolveSites(SiteSet{ site }).front();
+    size_t first, last;
+    findRange(startDate, endDate, first, last);
+
+    std::vector<RowData> result;
+    for (size_t position = first; position < last; ++position) {
+        if (siteSeries.has(position)) {
+            result.emplace_back(timeline[position], siteSeries.values[0][position], siteSeries.values[1][position],
+                siteSeries.values[2][position], siteSeries.values[3][position], siteSeries.values[4][position]);
+        }
+    }
+    return result;
+}
+
+/// \brief Oblicza statystyki zbiorcze wszystkich odczytw wskazanych instalacji w przedziale czasowym.
+/// \details Kada seria jest przegldana jednym przebiegiem: mapa obecnoci jest czytana sowo po sowie,
+/// a dla kadego odczytu aktualizowane s naraz licznik i statystyki wszystkich kanaw.
+Aggregate MultiSiteData::calculateStatsBetweenDates(const SiteSet& sites, const std::string& startDate,
+    const std::string& endDate) const {
+    std::vector<const Series*> selected = resolveSites(sites);
+    size_t first, last;
+    findRange(startDate, endDate, first, last);
+
+    Aggregate result;
+    for (const Series* siteSeries : selected) {
+        const float* values[CHANNEL_COUNT];
+        double sum[CHANNEL_COUNT] = {}, sumSquares[CHANNEL_COUNT] = {};
+        float low[CHANNEL_COUNT], high[CHANNEL_COUNT];
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            values[channel] = siteSeries->values[channel].data();
+            low[channel] = result.min[channel];
+            high[channel] = result.max[channel];
+        }
+
+        size_t readings = 0;
+        for (size_t wordStart = first & ~size_t(63); wordStart < last; wordStart += 64) {
+            uint64_t word = siteSeries->present[wordStart >> 6];
+            if (wordStart < first) {
+                word &= ~uint64_t(0) << (first - wordStart);  ///< Pominicie pozycji przed przedziaem
+            }
+            if (last - wordStart < 64) {
+                word &= (uint64_t(1) << (last - wordStart)) - 1;  ///< Pominicie pozycji za przedziaem
+            }
+            for (size_t position = wordStart; word != 0; ++position, word >>= 1) {
+                if (!(word & 1)) continue;
+                ++readings;
+                for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                    float value = values[channel][position];
+                    sum[channel] += value;
+                    sumSquares[channel] += static_cast<double>(value) * value;
+                    low[channel] = std::min(low[channel], value);
+                    high[channel] = std::max(high[channel], value);
+                }
+            }
+        }
+
+        result.count += readings;
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            result.sum[channel] += sum[channel];
+            result.sumSquares[channel] += sumSquares[channel];
+            result.min[channel] = low[channel];
+            result.max[channel] = high[channel];
+        }
+    }
+    return result;
+}
+
+/// \brief Sumuje odczyty wskazanych instalacji dla kadego znacznika czasu z przedziau.
+std::vector<RowData> MultiSiteData::totalsBetweenDates(const SiteSet& sites, const std::string& startDate,
+    const std::string& endDate) const {
+    std::vector<const Series*> selected = resolveSites(sites);
+    size_t first, last;
+    findRange(startDate, endDate, first, last);
+
+    std::vector<RowData> result;
+    result.reserve(last - first);
+    for (size_t position = first; position < last; ++position) {
+        float total[CHANNEL_COUNT] = {};
+        bool any = false;
+        for (const Series* siteSeries : selected) {
+            if (!siteSeries->has(position)) continue;
+            any = true;
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                total[channel] += siteSeries->values[channel][position];
+            }
+        }
+        if (any) {
+            result.emplace_back(timeline[position], total[0], total[1], total[2], total[3], total[4]);
+        }
+    }
+    return result;
+}
+
+/// \brief Zwraca seri instalacji, tworzc j w razie potrzeby.
+/// \details Nowa seria ma kolumny o dugoci osi czasu, wypenione zerami, i pust map obecnoci.
+MultiSiteData::Series& MultiSiteData::seriesFor(const std::string& site) {
+    auto found = siteIndex.find(site);
+    if (found != siteIndex.end()) {
+        return series[found->second];
+    }
+    siteIndex.emplace(site, series.size());
+    series.emplace_back();
+    Series& siteSeries = series.back();
+    siteSeries.name = site;
+    for (auto& column : siteSeries.values) {
+        column.assign(timeline.size(), 0.0f);
+    }
+    siteSeries.present.assign((timeline.size() + 63) / 64, 0);
+    return siteSeries;
+}
+
+/// \brief Zamienia nazwy instalacji na wskaniki do serii.
+/// \details Pusty zbir oznacza wszystkie instalacje. Powtrzone nazwy s pomijane, wic kada instalacja
+/// jest liczona w wynikach co najwyej raz.
+std::vector<const MultiSiteData::Series*> MultiSiteData::resolveSites(const SiteSet& sites) const {
+    std::vector<const Series*> selected;
+    if (sites.empty()) {
+        for (const auto& siteSeries : series) {
+            selected.push_back(&siteSeries);
+        }
+        return selected;
+    }
+    for (const auto& site : sites) {
+        auto found = siteIndex.find(site);
+        if (found == siteIndex.end()) {
+            throw std::invalid_argument("Nieznana instalacja: " + site);
+        }
+        const Series* siteSeries = &series[found->second];
+        if (std::find(selected.begin(), selected.end(), siteSeries) == selected.end()) {
+            selected.push_back(siteSeries);
+        }
+    }
+    return selected;
+}
+
+/// \brief Wyznacza zakres pozycji osi czasu odpowiadajcy przedziaowi dat.
+/// \details Obie granice wyszukiwane s binarnie; koniec przedziau jest wczny.
+void MultiSiteData::findRange(const std::string& startDate, const std::string& endDate, size_t& first, size_t& last) const {
+    int32_t start = parseTimestamp(startDate);
+    int32_t end = parseTimestamp(endDate);
+
+    first = std::lower_bound(timeline.begin(), timeline.end(), start) - timeline.begin();
+    last = end < start ? first : std::upper_bound(timeline.begin(), timeline.end(), end) - timeline.begin();
+}
@@ -0,0 +1,126 @@
+/// \file MultiSiteData.h
+/// \brief Deklaracja klasy MultiSiteData - wielu nazwanych serii pomiarowych na wsplnej osi czasu.
+
+#ifndef MULTISITEDATA_H
+#define MULTISITEDATA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RowData.h" ///< Wiersze danych wczytywane do serii.
+#include "Aggregate.h" ///< Statystyki zbiorcze wynikw.
+
+/// \class MultiSiteData
+/// \brief Przechowuje serie wielu instalacji (lokalizacji, licznikw) na jednej, wsplnej osi czasu.
+/// O czasu to posortowany wektor unikalnych znacznikw czasu wszystkich serii. Kada seria ma kolumny wartoci
+/// wyrwnane do tej osi oraz map bitow obecnoci odczytw, wic znaczniki czasu nie s powielane dla kadej
+/// instalacji - jeden odczyt zajmuje 20 bajtw zamiast 24. Luki w serii kosztuj tyle samo, co odczyty,
+/// dlatego klasa najlepiej sprawdza si dla instalacji raportujcych w tym samym rytmie.
+/// Dane s dodawane paczkami (addSeries, loadFiles): o czasu jest scalana raz na paczk, a istniejce serie
+/// przenoszone na nowe pozycje jednym przebiegiem.
+class MultiSiteData {
+public:
+    using SiteSet = std::vector<std::string>; ///< Zbir nazw instalacji, ktrych dotyczy zapytanie (powtrzenia s pomijane).
+
+    /// \struct SiteRows
+    /// \brief Wiersze jednej instalacji dodawane w paczce.
+    struct SiteRows {
+        std::string site; ///< Nazwa instalacji.
+        std::vector<RowData> rows; ///< Wiersze w dowolnej kolejnoci.
+    };
+
+    /// \struct SiteFile
+    /// \brief Plik CSV z danymi jednej instalacji.
+    struct SiteFile {
+        std::string site; ///< Nazwa instalacji.
+        std::string path; ///< cieka do pliku CSV.
+    };
+
+    /// \brief Dodaje paczk wierszy wielu instalacji.
+    /// \param batch Wiersze pogrupowane wedug instalacji; nieznane instalacje s tworzone.
+    /// \details Odczyt o znaczniku czasu, ktry instalacja ju ma, zastpuje poprzedni.
+    void addSeries(const std::vector<SiteRows>& batch);
+
+    /// \brief Wczytuje pliki CSV wielu instalacji jako jedn paczk.
+    /// \param files Pliki i nazwy instalacji.
+    /// \return Liczba wczytanych wierszy.
+    /// \throws std::runtime_error Jeli ktrego pliku nie mona otworzy (adne dane nie s wtedy dodawane).
+    /// \details Pliki s parsowane rwnolegle we wsplnej puli wtkw, a niepoprawne wiersze logowane tak samo,
+    /// jak przy wczytywaniu pojedynczej serii.
+    size_t loadFiles(const std::vector<SiteFile>& files);
+
+    /// \brief Zwraca liczb instalacji.
+    size_t siteCount() const { return series.size(); }
+
+    /// \brief Zwraca nazwy instalacji w kolejnoci ich dodania.
+    std::vector<std::string> siteNames() const;
+
+    /// \brief Sprawdza, czy instalacja o podanej nazwie istnieje.
+    bool hasSite(const std::string& site) const { return siteIndex.count(site) != 0; }
+
+    /// \brief Zwraca liczb znacznikw czasu na wsplnej osi.
+    size_t timelineSize() const { return timeline.size(); }
+
+    /// \brief Zwraca liczb odczytw instalacji.
+    /// \throws std::invalid_argument Jeli instalacja nie istnieje.
+    size_t readingCount(const std::string& site) const;
+
+    /// \brief Zwraca wiersze instalacji z przedziau czasowego.
+    /// \param site Nazwa instalacji.
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm (wcznie).
+    /// \throws std::invalid_argument Jeli instalacja nie istnieje lub data ma bdny format.
+    std::vector<RowData> getSiteDataBetweenDates(const std::string& site, const std::string& startDate,
+        const std::string& endDate) const;
+
+    /// \brief Oblicza statystyki zbiorcze wszystkich odczytw wskazanych instalacji w przedziale czasowym.
+    /// \param sites Instalacje (pusty zbir - wszystkie).
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm (wcznie).
+    /// \return czna liczba odczytw, sumy, minima i maksima kanaw we wszystkich instalacjach.
+    /// \throws std::invalid_argument Jeli ktra instalacja nie istnieje lub data ma bdny format.
+    Aggregate calculateStatsBetweenDates(const SiteSet& sites, const std::string& startDate,
+        const std::string& endDate) const;
+
+    /// \brief Sumuje odczyty wskazanych instalacji dla kadego znacznika czasu z przedziau.
+    /// \param sites Instalacje (pusty zbir - wszystkie).
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm (wcznie).
+    /// \return Seria sum, w kolejnoci chronologicznej; pomijane s chwile bez odczytu adnej z instalacji.
+    /// \throws std::invalid_argument Jeli ktra instalacja nie istnieje lub data ma bdny format.
+    /// \details Wynik powstaje jednym przebiegiem po osi czasu: dla kadej pozycji dodawane s kolumny
+    /// wszystkich wskazanych instalacji.
+    std::vector<RowData> totalsBetweenDates(const SiteSet& sites, const std::string& startDate,
+        const std::string& endDate) const;
+
+private:
+    /// \struct Series
+    /// \brief Seria jednej instalacji, wyrwnana do wsplnej osi czasu.
+    struct Series {
+        std::string name; ///< Nazwa instalacji.
+        std::vector<float> values[CHANNEL_COUNT]; ///< Kolumny wartoci kanaw (0 tam, gdzie brak odczytu).
+        std::vector<uint64_t> present; ///< Mapa bitowa obecnoci odczytw, po bicie na pozycj osi czasu.
+        size_t readings = 0; ///< Liczba odczytw.
+
+        /// \brief Sprawdza, czy seria ma odczyt na pozycji osi czasu.
+        bool has(size_t position) const { return (present[position >> 6] >> (position & 63)) & 1; }
+    };
+
+    /// \brief Zwraca seri instalacji, tworzc j w razie potrzeby.
+    Series& seriesFor(const std::string& site);
+
+    /// \brief Zamienia nazwy instalacji na wskaniki do serii, bez powtrze.
+    /// \throws std::invalid_argument Jeli ktra instalacja nie istnieje.
+    std::vector<const Series*> resolveSites(const SiteSet& sites) const;
+
+    /// \brief Wyznacza zakres pozycji osi czasu odpowiadajcy przedziaowi dat.
+    void findRange(const std::string& startDate, const std::string& endDate, size_t& first, size_t& last) const;
+
+    std::vector<int32_t> timeline; ///< Wsplna, posortowana o czasu bez powtrze.
+    std::vector<Series> series; ///< Serie instalacji w kolejnoci dodania.
+    std::unordered_map<std::string, size_t> siteIndex; ///< Numer serii dla nazwy instalacji.
+};
+
+#endif // MULTISITEDATA_H
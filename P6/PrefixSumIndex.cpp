@@ -0,0 +1,167 @@
+/// \file PrefixSumIndex.cpp
+/// \brief Implementacja indeksu sum prefiksowych dla kanaw pomiarowych.
+
+#include "PrefixSumIndex.h"
+#include <algorithm>
+
+/// \brief Tworzy pusty indeks.
+PrefixSumIndex::PrefixSumIndex() {
+    bindOwned();
+}
+
+/// \brief Kopiuje indeks; wypoyczone sumy pozostaj wspdzielone z oryginaem.
+PrefixSumIndex::PrefixSumIndex(const PrefixSumIndex& other) : owner(other.owner) {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        prefixColumns[channel] = other.prefixColumns[channel];
+    }
+    if (owner) {
+        std::copy(other.prefixData, other.prefixData + CHANNEL_COUNT, prefixData);
+        prefixLength = other.prefixLength;
+    }
+    else {
+        bindOwned();
+    }
+}
+
+/// \brief Przypisuje zawarto innego indeksu.
+PrefixSumIndex& PrefixSumIndex::operator=(const PrefixSumIndex& other) {
+    if (this != &other) {
+        PrefixSumIndex copy(other);
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            prefixColumns[channel].swap(copy.prefixColumns[channel]);
+        }
+        owner = copy.owner;
+        if (owner) {
+            std::copy(copy.prefixData, copy.prefixData + CHANNEL_COUNT, prefixData);
+            prefixLength = copy.prefixLength;
+        }
+        else {
+            bindOwned();
+        }
+    }
+    return *this;
+}
+
+/// \brief Przenosi sumy innego indeksu bez kopiowania.
+PrefixSumIndex::PrefixSumIndex(PrefixSumIndex&& other) noexcept : owner(std::move(other.owner)) {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        prefixColumns[channel] = std::move(other.prefixColumns[channel]);
+    }
+    if (owner) {
+        std::copy(other.prefixData, other.prefixData + CHANNEL_COUNT, prefixData);
+        prefixLength = other.prefixLength;
+    }
+    else {
+        bindOwned();
+    }
+    other.clear();
+}
+
+/// \brief Przenosi sumy innego indeksu bez kopiowania.
+PrefixSumIndex& PrefixSumIndex::operator=(PrefixSumIndex&& other) noexcept {
+    if (this != &other) {
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            prefixColumns[channel] = std::move(other.prefixColumns[channel]);
+        }
+        owner = std::move(other.owner);
+        if (owner) {
+            std::copy(other.prefixData, other.prefixData + CHANNEL_COUNT, prefixData);
+            prefixLength = other.prefixLength;
+        }
+        else {
+            bindOwned();
+        }
+        other.clear();
+    }
+    return *this;
+}
+
+/// \brief Podcza sumy prefiksowe z zewntrznej pamici bez kopiowania.
+void PrefixSumIndex::attach(const double* const prefixes[CHANNEL_COUNT], size_t length,
+    std::shared_ptr<const void> memoryOwner) {
+    for (auto& prefix : prefixColumns) {
+        std::vector<double>().swap(prefix);
+    }
+    std::copy(prefixes, prefixes + CHANNEL_COUNT, prefixData);
+    prefixLength = length;
+    owner = std::move(memoryOwner);
+}
+
+/// \brief Aktualizuje indeks po wstawieniu wiersza do magazynu.
+/// \param store Magazyn, do ktrego wstawiono wiersz.
+/// \param index Pozycja, na ktrej wiersz zosta wstawiony.
+void PrefixSumIndex::insert(const ColumnStore& store, size_t index) {
+    detach();
+    if (index + 1 == store.size() && prefixColumns[0].size() == store.size()) {
+        // Dopisanie chronologiczne - wystarczy jeden nowy element na kana
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            std::vector<double>& prefix = prefixColumns[channel];
+            prefix.push_back(prefix.back() + store.valueAt(static_cast<Channel>(channel), index));
+        }
+        bindOwned();
+        return;
+    }
+    recompute(store, index);
+}
+
+/// \brief Aktualizuje indeks po wstawieniu wielu wierszy naraz.
+/// \param store Magazyn, do ktrego wstawiono wiersze.
+/// \param first Najmniejsza pozycja, na ktrej wstawiono wiersz.
+void PrefixSumIndex::insertRange(const ColumnStore& store, size_t first) {
+    recompute(store, first);
+}
+
+/// \brief Buduje indeks od nowa na podstawie caego magazynu.
+void PrefixSumIndex::rebuild(const ColumnStore& store) {
+    owner.reset();  ///< Wypoyczonych sum nie trzeba kopiowa - wszystkie zostan przeliczone
+    recompute(store, 0);
+}
+
+/// \brief Usuwa zawarto indeksu.
+void PrefixSumIndex::clear() {
+    owner.reset();
+    for (auto& prefix : prefixColumns) {
+        prefix.clear();
+    }
+    bindOwned();
+}
+
+/// \brief Przelicza sumy prefiksowe od podanej pozycji do koca magazynu.
+/// \param store Magazyn wierszy.
+/// \param from Pierwsza pozycja, ktrej suma moga si zmieni.
+void PrefixSumIndex::recompute(const ColumnStore& store, size_t from) {
+    detach();
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        std::vector<double>& prefix = prefixColumns[channel];
+        const float* values = store.column(static_cast<Channel>(channel));
+        if (prefix.empty()) {
+            prefix.push_back(0.0);
+        }
+        prefix.resize(store.size() + 1);
+        for (size_t i = from; i < store.size(); ++i) {
+            prefix[i + 1] = prefix[i] + values[i];
+        }
+    }
+    bindOwned();
+}
+
+/// \brief Kopiuje wypoyczone sumy do wasnych wektorw.
+/// \details Wywoywana przed kad modyfikacj; dla wasnych kolumn nic nie robi.
+void PrefixSumIndex::detach() {
+    if (!owner) {
+        return;
+    }
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        prefixColumns[channel].assign(prefixData[channel], prefixData[channel] + prefixLength);
+    }
+    owner.reset();
+    bindOwned();
+}
+
+/// \brief Ustawia wskaniki odczytu na wasne wektory.
+void PrefixSumIndex::bindOwned() {
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        prefixData[channel] = prefixColumns[channel].data();
+    }
+    prefixLength = prefixColumns[0].size();
+}
@@ -0,0 +1,95 @@
+/// \file PrefixSumIndex.h
+/// \brief Deklaracja klasy PrefixSumIndex - indeksu sum prefiksowych dla kanaw pomiarowych.
+
+#ifndef PREFIXSUMINDEX_H
+#define PREFIXSUMINDEX_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "ColumnStore.h" ///< Kolumnowy magazyn wierszy, na ktrym budowany jest indeks.
+
+/// \class PrefixSumIndex
+/// \brief Przechowuje skumulowane sumy (w podwjnej precyzji) kadego kanau po wierszach posortowanych wedug czasu.
+/// Suma kanau w dowolnym zakresie pozycji [first, last) to rnica dwch elementw indeksu, wic sumy i rednie
+/// dla przedziaw dat liczone s bez przegldania wierszy i bez alokacji pamici.
+/// Podobnie jak ColumnStore, indeks moe czyta sumy z zewntrznej pamici tylko do odczytu (attach()).
+class PrefixSumIndex {
+public:
+    /// \brief Tworzy pusty indeks.
+    PrefixSumIndex();
+
+    /// \brief Kopiuje indeks; wypoyczone sumy pozostaj wspdzielone z oryginaem (bez kopiowania danych).
+    PrefixSumIndex(const PrefixSumIndex& other);
+
+    /// \brief Przypisuje kopi innego indeksu.
+    PrefixSumIndex& operator=(const PrefixSumIndex& other);
+
+    /// \brief Przenosi sumy innego indeksu bez kopiowania; wypoyczona pami pozostaje wspdzielona.
+    /// \details Indeks rdowy zostaje pusty.
+    PrefixSumIndex(PrefixSumIndex&& other) noexcept;
+
+    /// \brief Przenosi sumy innego indeksu bez kopiowania (indeks rdowy zostaje pusty).
+    PrefixSumIndex& operator=(PrefixSumIndex&& other) noexcept;
+
+    /// \brief Podcza sumy prefiksowe z zewntrznej pamici bez kopiowania.
+    /// \param prefixes Sumy prefiksowe kanaw, kada o dugoci length.
+    /// \param length Liczba elementw kadej kolumny (liczba wierszy + 1).
+    /// \param owner Obiekt utrzymujcy pami przy yciu (np. odwzorowany plik).
+    void attach(const double* const prefixes[CHANNEL_COUNT], size_t length, std::shared_ptr<const void> owner);
+
+    /// \brief Kopiuje wypoyczone sumy do wasnych wektorw i zwalnia wypoyczon pami.
+    /// \details Wywoywana przed kad modyfikacj; dla wasnych sum nic nie robi.
+    void detach();
+
+    /// \brief Zwraca wskanik na sumy prefiksowe kanau (size() + 1 elementw lub nullptr dla pustego indeksu).
+    const double* data(Channel channel) const { return prefixData[static_cast<int>(channel)]; }
+
+    /// \brief Zwraca liczb elementw kadej kolumny indeksu (liczba wierszy + 1 lub 0 dla pustego indeksu).
+    size_t length() const { return prefixLength; }
+
+    /// \brief Aktualizuje indeks po wstawieniu wiersza do magazynu.
+    /// \param store Magazyn, do ktrego wstawiono wiersz.
+    /// \param index Pozycja, na ktrej wiersz zosta wstawiony.
+    /// \details Dopisanie na koniec kosztuje O(1). Wstawienie w rodek przelicza sumy od pozycji wstawienia,
+    /// poniewa zmieniaj si wszystkie kolejne elementy indeksu.
+    void insert(const ColumnStore& store, size_t index);
+
+    /// \brief Aktualizuje indeks po wstawieniu wielu wierszy naraz.
+    /// \param store Magazyn, do ktrego wstawiono wiersze.
+    /// \param first Najmniejsza pozycja, na ktrej wstawiono wiersz.
+    /// \details Sumy s przeliczane jednym przebiegiem od pozycji first; dla paczki dopisanej na koniec
+    /// kosztuje to tyle, ile wierszy ma paczka.
+    void insertRange(const ColumnStore& store, size_t first);
+
+    /// \brief Buduje indeks od nowa na podstawie caego magazynu.
+    /// \param store Magazyn wierszy.
+    void rebuild(const ColumnStore& store);
+
+    /// \brief Usuwa zawarto indeksu.
+    void clear();
+
+    /// \brief Zwraca sum kanau dla wierszy na pozycjach [first, last).
+    /// \param channel Kana pomiarowy.
+    /// \param first Pozycja pierwszego wiersza.
+    /// \param last Pozycja za ostatnim wierszem.
+    /// \return Suma wartoci kanau w podwjnej precyzji.
+    double sum(Channel channel, size_t first, size_t last) const {
+        const double* prefix = prefixData[static_cast<int>(channel)];
+        return last > first ? prefix[last] - prefix[first] : 0.0;
+    }
+
+private:
+    /// \brief Przelicza sumy prefiksowe od podanej pozycji do koca magazynu.
+    void recompute(const ColumnStore& store, size_t from);
+
+    /// \brief Ustawia wskaniki odczytu na wasne wektory.
+    void bindOwned();
+
+    std::vector<double> prefixColumns[CHANNEL_COUNT]; ///< Sumy prefiksowe kanaw; element i to suma wierszy [0, i).
+    const double* prefixData[CHANNEL_COUNT]; ///< Odczytywane sumy prefiksowe (wasne lub wypoyczone).
+    size_t prefixLength; ///< Liczba elementw kadej kolumny.
+    std::shared_ptr<const void> owner; ///< Waciciel wypoyczonej pamici; pusty dla wasnych kolumn.
+};
+
+#endif // PREFIXSUMINDEX_H
@@ -0,0 +1,161 @@
+/// \file RangeView.cpp
+/// \brief Implementacja leniwego widoku na zakres wierszy magazynu kolumnowego.
+
+#include "RangeView.h"
+#include "AggregateKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+/// \brief Tworzy iterator wskazujcy na pierwszy wiersz od pozycji index speniajcy filtry widoku.
+RangeView::Iterator::Iterator(const RangeView* view, size_t index) : view(view), index(index) {
+    skipRejected();
+}
+
+/// \brief Przechodzi do nastpnego wiersza speniajcego filtry.
+RangeView::Iterator& RangeView::Iterator::operator++() {
+    ++index;
+    skipRejected();
+    return *this;
+}
+
+/// \brief Przechodzi do nastpnego wiersza speniajcego filtry (postinkrementacja).
+RangeView::Iterator RangeView::Iterator::operator++(int) {
+    Iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+/// \brief Przesuwa pozycj do pierwszego wiersza speniajcego filtry.
+void RangeView::Iterator::skipRejected() {
+    if (!view->predicate) {
+        return;
+    }
+    while (index < view->last && !(*view->predicate)(Row(view->store, index))) {
+        ++index;
+    }
+}
+
+/// \brief Tworzy pusty widok.
+RangeView::RangeView() : store(nullptr), first(0), last(0) {
+}
+
+/// \brief Tworzy widok na wiersze magazynu z pozycji [first, last).
+RangeView::RangeView(const ColumnStore& store, size_t first, size_t last) : store(&store), first(first), last(last) {
+}
+
+/// \brief Zwraca liczb wierszy speniajcych filtry.
+size_t RangeView::count() const {
+    if (!predicate) {
+        return size();
+    }
+    size_t chunks = parallelChunks();
+    if (chunks > 0) {
+        std::vector<size_t> partial(chunks, 0);  ///< Liczba wierszy kadego fragmentu
+        ThreadPool::shared().parallelFor(chunks, [this, &partial](size_t chunk) {
+            size_t from = first + chunk * PARALLEL_CHUNK_ROWS;
+            size_t to = std::min(last, from + PARALLEL_CHUNK_ROWS);
+            for (size_t index = from; index < to; ++index) {
+                partial[chunk] += (*predicate)(Row(store, index));
+            }
+        });
+        size_t result = 0;
+        for (size_t chunkCount : partial) {
+            result += chunkCount;
+        }
+        return result;
+    }
+    size_t result = 0;
+    for (Iterator it = begin(); it != end(); ++it) {
+        ++result;
+    }
+    return result;
+}
+
+/// \brief Zwraca nowy widok, w ktrym wiersze musz dodatkowo spenia podany warunek.
+/// \details Nowy warunek jest czony z dotychczasowymi; widok rdowy pozostaje bez zmian.
+RangeView RangeView::filter(Predicate condition) const {
+    RangeView result = *this;
+    if (predicate) {
+        std::shared_ptr<const Predicate> previous = predicate;
+        result.predicate = std::make_shared<const Predicate>([previous, condition](const Row& row) {
+            return (*previous)(row) && condition(row);
+        });
+    }
+    else {
+        result.predicate = std::make_shared<const Predicate>(std::move(condition));
+    }
+    return result;
+}
+
+/// \brief Zwraca nowy widok ograniczony do wierszy, w ktrych warto kanau mieci si w [low, high].
+RangeView RangeView::withValueBetween(Channel channel, float low, float high) const {
+    return filter([channel, low, high](const Row& row) {
+        float value = row.getValue(channel);
+        return value >= low && value <= high;
+    });
+}
+
+/// \brief Wywouje funkcj dla kadego wiersza widoku, w kolejnoci chronologicznej.
+void RangeView::forEach(const Visitor& visitor) const {
+    for (Iterator it = begin(); it != end(); ++it) {
+        visitor(*it);
+    }
+}
+
+/// \brief Oblicza statystyki zbiorcze wierszy widoku.
+Aggregate RangeView::aggregate() const {
+    Aggregate result;
+    if (store == nullptr) {
+        return result;
+    }
+    size_t chunks = parallelChunks();
+    if (chunks > 0) {
+        std::vector<Aggregate> partial(chunks);  ///< Statystyki czstkowe fragmentw
+        ThreadPool::shared().parallelFor(chunks, [this, &partial](size_t chunk) {
+            size_t from = first + chunk * PARALLEL_CHUNK_ROWS;
+            aggregatePositions(from, std::min(last, from + PARALLEL_CHUNK_ROWS), partial[chunk]);
+        });
+        for (const Aggregate& chunkStats : partial) {
+            result.merge(chunkStats);  ///< Scalanie w staej kolejnoci fragmentw
+        }
+        return result;
+    }
+    aggregatePositions(first, last, result);
+    return result;
+}
+
+/// \brief Dodaje do statystyki wiersze widoku z pozycji [from, to) speniajce filtry.
+void RangeView::aggregatePositions(size_t from, size_t to, Aggregate& result) const {
+    if (!predicate) {
+        AggregateKernels::aggregate(*store, from, to, result);  ///< Przebieg wektorowy po kolumnach
+        return;
+    }
+    for (size_t index = from; index < to; ++index) {
+        Row row(store, index);
+        if ((*predicate)(row)) {
+            result.add(row.toRowData());
+        }
+    }
+}
+
+/// \brief Zwraca liczb fragmentw, na ktre dzielony jest widok w obliczeniach rwnolegych (0 - obliczenia szeregowe).
+/// \details Podzia nie zaley od liczby wtkw - na maszynie jednordzeniowej fragmenty s liczone po kolei,
+/// ale scalane tak samo, wic wynik jest identyczny.
+size_t RangeView::parallelChunks() const {
+    if (size() < PARALLEL_MIN_ROWS) {
+        return 0;
+    }
+    return (size() + PARALLEL_CHUNK_ROWS - 1) / PARALLEL_CHUNK_ROWS;
+}
+
+/// \brief Kopiuje wiersze widoku do wektora obiektw RowData.
+std::vector<RowData> RangeView::toVector() const {
+    std::vector<RowData> result;
+    if (!predicate) {
+        result.reserve(size());
+    }
+    for (Iterator it = begin(); it != end(); ++it) {
+        result.push_back((*it).toRowData());
+    }
+    return result;
+}
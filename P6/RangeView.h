@@ -0,0 +1,183 @@
+/// \file RangeView.h
+/// \brief Deklaracja klasy RangeView - leniwego widoku na zakres wierszy magazynu kolumnowego.
+
+#ifndef RANGEVIEW_H
+#define RANGEVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "ColumnStore.h" ///< Kolumnowy magazyn wierszy, na ktry wskazuje widok.
+#include "Aggregate.h" ///< Statystyki zbiorcze wierszy widoku.
+
+/// \class RangeView
+/// \brief Widok na cigy zakres wierszy magazynu kolumnowego, bez kopiowania danych.
+/// Iterowanie zwraca lekkie odwoania do wierszy (Row), ktre czytaj wartoci wprost z kolumn. Na widok mona
+/// nakada kolejne filtry (filter(), withValueBetween()) - kady zwraca nowy widok, a wiersze s sprawdzane
+/// dopiero podczas przegldania. Widok jest wany, dopki magazyn, z ktrego powsta, nie zostanie zmieniony
+/// (np. przez TreeData::addData) ani usunity.
+class RangeView {
+public:
+    /// \class Row
+    /// \brief Odwoanie do jednego wiersza magazynu.
+    class Row {
+    public:
+        /// \brief Tworzy odwoanie do wiersza na podanej pozycji magazynu.
+        Row(const ColumnStore* store, size_t index) : store(store), index(index) {}
+
+        /// \brief Zwraca pozycj wiersza w magazynie.
+        size_t position() const { return index; }
+
+        /// \brief Zwraca znacznik czasu wiersza (minuty od 01.01.1970).
+        int32_t getTimestamp() const { return store->timestampAt(index); }
+
+        /// \brief Zwraca dat wiersza w formacie dd.mm.yyyy hh:mm.
+        std::string getDate() const { return formatTimestamp(getTimestamp()); }
+
+        /// \brief Zwraca warto wskazanego kanau.
+        float getValue(Channel channel) const { return store->valueAt(channel, index); }
+
+        /// \brief Zwraca autokonsumpcj.
+        float getSelfConsumption() const { return getValue(Channel::SelfConsumption); }
+
+        /// \brief Zwraca eksport energii.
+        float getExport() const { return getValue(Channel::Export); }
+
+        /// \brief Zwraca import energii.
+        float getImport() const { return getValue(Channel::Import); }
+
+        /// \brief Zwraca pobr energii.
+        float getConsumption() const { return getValue(Channel::Consumption); }
+
+        /// \brief Zwraca produkcj energii.
+        float getProduction() const { return getValue(Channel::Production); }
+
+        /// \brief Tworzy kopi wiersza w postaci obiektu RowData.
+        RowData toRowData() const { return store->rowAt(index); }
+
+    private:
+        const ColumnStore* store; ///< Magazyn zawierajcy wiersz.
+        size_t index; ///< Pozycja wiersza w magazynie.
+    };
+
+    using Predicate = std::function<bool(const Row&)>; ///< Warunek, ktry musi speni wiersz widoku.
+    using Visitor = std::function<void(const Row&)>; ///< Funkcja wywoywana dla kadego wiersza widoku.
+
+    /// \class Iterator
+    /// \brief Iterator jednokierunkowy po wierszach widoku, pomijajcy wiersze niespeniajce filtrw.
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag; ///< Kategoria iteratora.
+        using value_type = Row; ///< Typ elementu.
+        using difference_type = std::ptrdiff_t; ///< Typ rnicy pozycji.
+        using pointer = const Row*; ///< Typ wskanika na element.
+        using reference = Row; ///< Typ zwracany przez operator*.
+
+        /// \brief Tworzy iterator wskazujcy na pierwszy wiersz od pozycji index speniajcy filtry widoku.
+        Iterator(const RangeView* view, size_t index);
+
+        /// \brief Zwraca biecy wiersz.
+        Row operator*() const { return Row(view->store, index); }
+
+        /// \brief Przechodzi do nastpnego wiersza speniajcego filtry.
+        Iterator& operator++();
+
+        /// \brief Przechodzi do nastpnego wiersza speniajcego filtry (postinkrementacja).
+        Iterator operator++(int);
+
+        /// \brief Porwnuje pozycje iteratorw.
+        bool operator==(const Iterator& other) const { return index == other.index; }
+
+        /// \brief Porwnuje pozycje iteratorw.
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+    private:
+        /// \brief Przesuwa pozycj do pierwszego wiersza speniajcego filtry.
+        void skipRejected();
+
+        const RangeView* view; ///< Przegldany widok.
+        size_t index; ///< Pozycja biecego wiersza w magazynie.
+    };
+
+    /// \brief Tworzy pusty widok.
+    RangeView();
+
+    /// \brief Tworzy widok na wiersze magazynu z pozycji [first, last).
+    /// \param store Magazyn kolumnowy.
+    /// \param first Pozycja pierwszego wiersza.
+    /// \param last Pozycja za ostatnim wierszem.
+    RangeView(const ColumnStore& store, size_t first, size_t last);
+
+    /// \brief Zwraca iterator na pierwszy wiersz widoku.
+    Iterator begin() const { return Iterator(this, first); }
+
+    /// \brief Zwraca iterator za ostatnim wierszem widoku.
+    Iterator end() const { return Iterator(this, last); }
+
+    /// \brief Sprawdza, czy na widok naoono filtry.
+    bool isFiltered() const { return predicate != nullptr; }
+
+    /// \brief Zwraca liczb wierszy zakresu czasu, bez uwzgldnienia filtrw.
+    size_t size() const { return last - first; }
+
+    /// \brief Zwraca liczb wierszy speniajcych filtry.
+    /// \details Bez filtrw wynik jest natychmiastowy; z filtrami widok jest przegldany, a widoki liczce co
+    /// najmniej PARALLEL_MIN_ROWS wierszy - rwnolegle (filtry s wtedy wywoywane wspbienie z wielu wtkw).
+    size_t count() const;
+
+    /// \brief Sprawdza, czy aden wiersz nie spenia filtrw.
+    bool empty() const { return begin() == end(); }
+
+    /// \brief Zwraca wskanik na znaczniki czasu pierwszego wiersza zakresu (size() elementw, bez filtrw).
+    const int32_t* timestamps() const { return store != nullptr ? store->timestamps() + first : nullptr; }
+
+    /// \brief Zwraca wskanik na wartoci kanau pierwszego wiersza zakresu (size() elementw, bez filtrw).
+    const float* column(Channel channel) const { return store != nullptr ? store->column(channel) + first : nullptr; }
+
+    /// \brief Zwraca nowy widok, w ktrym wiersze musz dodatkowo spenia podany warunek.
+    /// \param condition Warunek nakadany na wiersze.
+    RangeView filter(Predicate condition) const;
+
+    /// \brief Zwraca nowy widok ograniczony do wierszy, w ktrych warto kanau mieci si w [low, high].
+    /// \param channel Kana pomiarowy.
+    /// \param low Dolna granica (wcznie).
+    /// \param high Grna granica (wcznie).
+    RangeView withValueBetween(Channel channel, float low, float high) const;
+
+    /// \brief Wywouje funkcj dla kadego wiersza widoku, w kolejnoci chronologicznej.
+    /// \param visitor Funkcja wywoywana dla wierszy.
+    void forEach(const Visitor& visitor) const;
+
+    /// \brief Oblicza statystyki zbiorcze wierszy widoku.
+    /// \details Bez filtrw kolumny s przegldane funkcjami wektorowymi (AggregateKernels). Widoki liczce
+    /// co najmniej PARALLEL_MIN_ROWS wierszy s dzielone na fragmenty po PARALLEL_CHUNK_ROWS wierszy, liczone
+    /// rwnolegle we wsplnej puli wtkw i scalane w kolejnoci fragmentw. Podzia zaley tylko od zakresu
+    /// widoku, wic wynik jest powtarzalny niezalenie od liczby wtkw.
+    Aggregate aggregate() const;
+
+    /// \brief Kopiuje wiersze widoku do wektora obiektw RowData.
+    std::vector<RowData> toVector() const;
+
+    static const size_t PARALLEL_MIN_ROWS = size_t(1) << 18; ///< Najmniejszy widok liczony rwnolegle (ok. 7,5 roku danych 15-minutowych).
+    static const size_t PARALLEL_CHUNK_ROWS = size_t(1) << 16; ///< Liczba wierszy fragmentu liczonego przez jedno zadanie.
+
+private:
+    /// \brief Dodaje do statystyki wiersze widoku z pozycji [from, to) speniajce filtry.
+    /// \param from Pozycja pierwszego wiersza.
+    /// \param to Pozycja za ostatnim wierszem.
+    /// \param[in,out] result Statystyka, do ktrej dodawane s wiersze.
+    void aggregatePositions(size_t from, size_t to, Aggregate& result) const;
+
+    /// \brief Zwraca liczb fragmentw, na ktre dzielony jest widok w obliczeniach rwnolegych (0 - obliczenia szeregowe).
+    size_t parallelChunks() const;
+
+    const ColumnStore* store; ///< Magazyn, na ktry wskazuje widok.
+    size_t first; ///< Pozycja pierwszego wiersza zakresu.
+    size_t last; ///< Pozycja za ostatnim wierszem zakresu.
+    std::shared_ptr<const Predicate> predicate; ///< Zoenie wszystkich filtrw; pusty, jeli widok nie jest filtrowany.
+};
+
+#endif // RANGEVIEW_H
@@ -25,14 +25,14 @@ RowData::RowData(const string& line) {
     }
 
     // Inicjalizacja pl obiektu na podstawie wczytanych wartoci.
-    this->date = values[0]; ///< Data wiersza.
+    this->timestamp = parseTimestamp(values[0]); ///< Data wiersza (parsowana jednokrotnie).
     this->selfConsumption = stof(values[1]); ///< Autokonsumpcja (w watach).
     this->exportValue = stof(values[2]); ///< Eksport energii (w watach).
     this->importValue = stof(values[3]); ///< Import energii (w watach).
     this->consumption = stof(values[4]); ///< Pobr energii (w watach).
     this->production = stof(values[5]); ///< Produkcja energii (w watach).
 
-    globalLogger.log("Wczytano linie: " + this->toString()); ///< Logowanie wczytanego wiersza.
+    P6_LOG_TRACE(globalLogger, "Wczytano linie: " + this->toString()); ///< Logowanie wczytanego wiersza (tylko poziom Trace).
 }
 
 /// \brief Konstruktor odczytujcy dane z pliku binarnego.
@@ -42,10 +42,31 @@ RowData::RowData(ifstream& in) {
     loadFromBinary(in); ///< Deserializacja danych z pliku binarnego.
 }
 
+/// \brief Konstruktor tworzcy wiersz z gotowych wartoci.
+/// \details Nie parsuje tekstu ani nie loguje - suy do odtwarzania wierszy zapisanych w magazynie kolumnowym.
+RowData::RowData(int32_t timestamp, float selfConsumption, float exportValue, float importValue,
+    float consumption, float production)
+    : timestamp(timestamp), selfConsumption(selfConsumption), exportValue(exportValue),
+    importValue(importValue), consumption(consumption), production(production) {
+}
+
+/// \brief Zwraca warto wskazanego kanau pomiarowego.
+/// \param channel Kana, ktrego warto ma zosta zwrcona.
+/// \return Warto kanau w watach (W).
+float RowData::getValue(Channel channel) const {
+    switch (channel) {
+    case Channel::SelfConsumption: return selfConsumption;
+    case Channel::Export: return exportValue;
+    case Channel::Import: return importValue;
+    case Channel::Consumption: return consumption;
+    default: return production;
+    }
+}
+
 /// \brief Wypisuje wszystkie dane na standardowe wyjcie.
 /// Funkcja ta drukuje dat oraz wszystkie wartoci energetyczne obiektu wiersza.
 void RowData::display() const {
-    cout << date << " " << selfConsumption << " " << exportValue << " " << importValue << " " << consumption << " " << production << endl;
+    cout << getDate() << " " << selfConsumption << " " << exportValue << " " << importValue << " " << consumption << " " << production << endl;
 }
 
 /// \brief Wypisuje tylko dane liczbowe (bez daty) na standardowe wyjcie.
@@ -58,8 +79,8 @@ void RowData::displayData() const {
 /// \return Dane w formacie tekstowym, zawierajce wszystkie wartoci wiersza.
 /// Funkcja ta zamienia dane obiektu na cig znakw, co moe by przydatne do zapisania
 /// lub wywietlenia danych w postaci tekstowej.
-string RowData::toString() {
-    return date + " " + to_string(selfConsumption) + " " + to_string(exportValue) + " " + to_string(importValue) + " " +
+string RowData::toString() const {
+    return getDate() + " " + to_string(selfConsumption) + " " + to_string(exportValue) + " " + to_string(importValue) + " " +
         to_string(consumption) + " " + to_string(production);
 }
 
@@ -67,6 +88,7 @@ string RowData::toString() {
 /// \param out Strumie wyjciowy, do ktrego zapisane bd dane obiektu.
 /// Funkcja zapisuje dane obiektu w formacie binarnym, umoliwiajc ich pniejsze odczytanie.
 void RowData::saveToBinary(ofstream& out) const {
+    string date = getDate(); ///< Data zapisywana w postaci tekstowej.
     size_t dateSize = date.size(); ///< Rozmiar daty wiersza w bajtach.
     out.write(reinterpret_cast<const char*>(&dateSize), sizeof(dateSize)); ///< Zapisanie rozmiaru daty.
     out.write(date.c_str(), dateSize); ///< Zapisanie daty w postaci tekstowej.
@@ -83,8 +105,9 @@ void RowData::saveToBinary(ofstream& out) const {
 void RowData::loadFromBinary(ifstream& in) {
     size_t dateSize; ///< Zmienna przechowujca rozmiar daty.
     in.read(reinterpret_cast<char*>(&dateSize), sizeof(dateSize)); ///< Wczytanie rozmiaru daty.
-    date.resize(dateSize); ///< Zmienna do przechowywania daty.
+    string date(dateSize, '\0'); ///< Zmienna do przechowywania daty.
     in.read(&date[0], dateSize); ///< Wczytanie samej daty.
+    timestamp = parseTimestamp(date); ///< Zamiana daty na znacznik czasu.
     in.read(reinterpret_cast<char*>(&selfConsumption), sizeof(selfConsumption)); ///< Wczytanie wartoci autokonsumpcji.
     in.read(reinterpret_cast<char*>(&exportValue), sizeof(exportValue)); ///< Wczytanie wartoci eksportu.
     in.read(reinterpret_cast<char*>(&importValue), sizeof(importValue)); ///< Wczytanie wartoci importu.
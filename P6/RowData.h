@@ -9,9 +9,23 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include "Timestamp.h" ///< Funkcje konwersji dat na znaczniki czasu.
 
 using namespace std;
 
+/// \enum Channel
+/// \brief Kanay pomiarowe (parametry energetyczne) zapisane w kadym wierszu danych.
+enum class Channel {
+    SelfConsumption, ///< Autokonsumpcja.
+    Export, ///< Eksport energii do sieci.
+    Import, ///< Import energii z sieci.
+    Consumption, ///< Pobr energii.
+    Production ///< Produkcja energii.
+};
+
+/// \brief Liczba kanaw pomiarowych w jednym wierszu danych.
+const int CHANNEL_COUNT = 5;
+
 /// \class RowData
 /// \brief Klasa reprezentujca dane jednego wiersza z pliku CSV, zawierajca rne parametry energetyczne.
 class RowData {
@@ -26,6 +40,17 @@ public:
     /// Inicjalizuje obiekt na podstawie zserializowanych danych zapisanych w pliku binarnym.
     RowData(ifstream& in);
 
+    /// \brief Konstruktor tworzcy wiersz z gotowych wartoci.
+    /// \param timestamp Znacznik czasu (minuty od 01.01.1970 00:00).
+    /// \param selfConsumption Autokonsumpcja w watach (W).
+    /// \param exportValue Eksport energii w watach (W).
+    /// \param importValue Import energii w watach (W).
+    /// \param consumption Pobr energii w watach (W).
+    /// \param production Produkcja energii w watach (W).
+    /// Uywany przy odtwarzaniu wierszy z kolumnowego magazynu danych, bez ponownego parsowania tekstu.
+    RowData(int32_t timestamp, float selfConsumption, float exportValue, float importValue,
+        float consumption, float production);
+
     /// \brief Wypisuje wszystkie dane obiektu na standardowe wyjcie.
     /// Funkcja ta drukuje pene dane wiersza, w tym dat i wszystkie wartoci energetyczne.
     void display() const;
@@ -37,7 +62,7 @@ public:
     /// \brief Zwraca dane w formie tekstowego cigu znakw.
     /// \return Dane w formacie tekstowym, ktre reprezentuj wszystkie wartoci wiersza.
     /// Funkcja ta zamienia dane obiektu na jedn lini tekstu w celu atwego zapisu lub wywietlenia.
-    string toString();
+    string toString() const;
 
     /// \brief Serializuje obiekt do pliku binarnego.
     /// \param out Strumie wyjciowy, do ktrego zapisane bd dane obiektu w formacie binarnym.
@@ -50,9 +75,15 @@ public:
     void loadFromBinary(ifstream& in);
 
     /// \brief Zwraca dat, ktra znajduje si w wierszu.
-    /// \return Data wiersza w formacie tekstowym (np. "YYYY-MM-DD").
-    /// Funkcja ta umoliwia pobranie daty przypisanej do danego wiersza danych.
-    string getDate() const { return date; }
+    /// \return Data wiersza w formacie tekstowym (dd.mm.yyyy hh:mm).
+    /// Data jest formatowana ze znacznika czasu dopiero w momencie wywoania, np. przy wywietlaniu.
+    string getDate() const { return formatTimestamp(timestamp); }
+
+    /// \brief Zwraca znacznik czasu wiersza.
+    /// \return Liczba minut od 01.01.1970 00:00, niezalena od strefy czasowej.
+    /// Znacznik jest wyznaczany jednokrotnie przy wczytywaniu wiersza, dziki czemu filtrowanie zakresw dat
+    /// sprowadza si do porwna liczb cakowitych.
+    int32_t getTimestamp() const { return timestamp; }
 
     /// \brief Zwraca warto autokonsumpcji z wiersza danych.
     /// \return Warto autokonsumpcji w watach (W) jako liczba zmiennoprzecinkowa.
@@ -79,8 +110,13 @@ public:
     /// Funkcja ta umoliwia dostp do wartoci produkcji energii przypisanej do danego wiersza.
     float getProduction() const { return production; }
 
+    /// \brief Zwraca warto wskazanego kanau pomiarowego.
+    /// \param channel Kana, ktrego warto ma zosta zwrcona.
+    /// \return Warto kanau w watach (W).
+    float getValue(Channel channel) const;
+
 private:
-    string date; ///< Data wiersza w formacie tekstowym (np. "YYYY-MM-DD").
+    int32_t timestamp; ///< Data wiersza jako liczba minut od 01.01.1970 00:00.
     float selfConsumption; ///< Autokonsumpcja w watach (W), ilo energii zuytej lokalnie.
     float exportValue; ///< Eksport energii w watach (W), ilo energii oddanej do sieci.
     float importValue; ///< Import energii w watach (W), ilo energii pobranej z sieci.
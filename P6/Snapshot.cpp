@@ -0,0 +1,129 @@
+/// \file Snapshot.cpp
+/// \brief Implementacja binarnego formatu migawki danych kolumnowych.
+
+#include "Snapshot.h"
+#include <cstring>
+#include <stdexcept>
+
+static_assert(sizeof(SnapshotHeader) == 40, "Nagwek migawki musi mie stay rozmiar");
+
+static const uint16_t BYTE_ORDER_MARK = 0x0102; ///< Znacznik kolejnoci bajtw zapisywany natywnie.
+
+/// \brief Zapisuje jeden blok kolumny: rozmiar, zawarto (jednym wywoaniem write) i CRC32.
+static void writeBlock(std::ostream& out, const void* data, uint64_t size) {
+    uint32_t crc = Snapshot::crc32(data, static_cast<size_t>(size));
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    if (size > 0) {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+    out.write(reinterpret_cast<const char*>(&crc), sizeof(crc));
+}
+
+/// \brief Wczytuje jeden blok kolumny bezporednio do docelowej pamici i sprawdza jego CRC32.
+static void readBlock(std::istream& in, void* data, uint64_t expectedSize) {
+    uint64_t size = 0;
+    uint32_t crc = 0;
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!in || size != expectedSize) {
+        throw std::runtime_error("Nieprawidowy rozmiar bloku migawki");
+    }
+    if (size > 0) {
+        in.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+    }
+    in.read(reinterpret_cast<char*>(&crc), sizeof(crc));
+    if (!in || crc != Snapshot::crc32(data, static_cast<size_t>(size))) {
+        throw std::runtime_error("Niezgodna suma kontrolna bloku migawki");
+    }
+}
+
+/// \brief Zapisuje magazyn do strumienia.
+/// \param store Magazyn kolumnowy do zapisania.
+/// \param out Strumie wyjciowy otwarty w trybie binarnym.
+void Snapshot::save(const ColumnStore& store, std::ostream& out) {
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "P6SN", 4);
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.channelCount = CHANNEL_COUNT;
+    header.rowCount = store.size();
+    if (!store.empty()) {
+        header.firstTimestamp = store.timestampAt(0);
+        header.lastTimestamp = store.timestampAt(store.size() - 1);
+    }
+    header.headerCrc = crc32(&header, sizeof(header));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    writeBlock(out, store.timestamps(), header.rowCount * sizeof(int32_t));
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        writeBlock(out, store.column(static_cast<Channel>(channel)), header.rowCount * sizeof(float));
+    }
+
+    if (!out) {
+        throw std::runtime_error("Nie mona zapisa migawki");
+    }
+}
+
+/// \brief Wczytuje magazyn ze strumienia.
+/// \param in Strumie wejciowy otwarty w trybie binarnym.
+/// \param[out] store Magazyn, ktrego zawarto zostanie zastpiona danymi z migawki.
+void Snapshot::load(std::istream& in, ColumnStore& store) {
+    SnapshotHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, "P6SN", 4) != 0) {
+        throw std::runtime_error("Plik nie jest migawk danych");
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw std::runtime_error("Migawka zapisana z inn kolejnoci bajtw");
+    }
+    if (header.version != VERSION || header.channelCount != CHANNEL_COUNT) {
+        throw std::runtime_error("Nieobsugiwana wersja migawki");
+    }
+    uint32_t headerCrc = header.headerCrc;
+    header.headerCrc = 0;
+    if (headerCrc != crc32(&header, sizeof(header))) {
+        throw std::runtime_error("Niezgodna suma kontrolna nagwka migawki");
+    }
+
+    try {
+        store.clear();
+        store.resize(static_cast<size_t>(header.rowCount));  ///< Jedyna alokacja kolumn
+        readBlock(in, store.mutableTimestamps(), header.rowCount * sizeof(int32_t));
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            readBlock(in, store.mutableColumn(static_cast<Channel>(channel)), header.rowCount * sizeof(float));
+        }
+        if (!store.isSorted() || (!store.empty() && (store.timestampAt(0) != header.firstTimestamp ||
+            store.timestampAt(store.size() - 1) != header.lastTimestamp))) {
+            throw std::runtime_error("Niespjny zakres czasu w migawce");
+        }
+    }
+    catch (...) {
+        store.clear();
+        throw;
+    }
+}
+
+/// \brief Oblicza sum kontroln CRC32 (wielomian IEEE 802.3, odwrcony 0xEDB88320).
+/// \details Tablica 256 wartoci jest liczona jednokrotnie przy pierwszym wywoaniu.
+uint32_t Snapshot::crc32(const void* data, size_t size, uint32_t crc) {
+    struct Table {
+        uint32_t values[256];
+        Table() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+                }
+                values[i] = value;
+            }
+        }
+    };
+    static const Table table;
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table.values[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
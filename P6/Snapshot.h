@@ -0,0 +1,59 @@
+/// \file Snapshot.h
+/// \brief Deklaracja klasy Snapshot - binarnego formatu migawki danych kolumnowych.
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include "ColumnStore.h" ///< Kolumnowy magazyn wierszy zapisywany w migawce.
+
+/// \struct SnapshotHeader
+/// \brief Nagwek pliku migawki o staym rozmiarze 40 bajtw.
+/// Wszystkie pola maj sta szeroko, a pole byteOrder pozwala wykry plik zapisany na maszynie
+/// o innej kolejnoci bajtw.
+struct SnapshotHeader {
+    char magic[4]; ///< Sygnatura pliku "P6SN".
+    uint16_t version; ///< Wersja formatu.
+    uint16_t byteOrder; ///< Znacznik kolejnoci bajtw (0x0102 zapisane natywnie).
+    uint32_t channelCount; ///< Liczba kolumn wartoci (CHANNEL_COUNT).
+    uint32_t reserved; ///< Pole zarezerwowane, zawsze 0.
+    uint64_t rowCount; ///< Liczba wierszy.
+    int32_t firstTimestamp; ///< Znacznik czasu pierwszego wiersza (0 dla pustej migawki).
+    int32_t lastTimestamp; ///< Znacznik czasu ostatniego wiersza (0 dla pustej migawki).
+    uint32_t headerCrc; ///< CRC32 nagwka liczone przy headerCrc = 0.
+    uint32_t padding; ///< Wyrwnanie do 8 bajtw, zawsze 0.
+};
+
+/// \class Snapshot
+/// \brief Zapisuje i odczytuje kolumnowy magazyn danych w wersjonowanym formacie binarnym.
+/// Po nagwku zapisywane s kolejno bloki: kolumna znacznikw czasu i pi kolumn wartoci. Kady blok to
+/// rozmiar w bajtach (uint64), surowa zawarto kolumny zapisana jednym wywoaniem write oraz CRC32 bloku.
+/// Odczyt alokuje kolumny jednokrotnie na podstawie liczby wierszy z nagwka i wczytuje je bezporednio.
+class Snapshot {
+public:
+    static const uint16_t VERSION = 1; ///< Bieca wersja formatu.
+
+    /// \brief Zapisuje magazyn do strumienia.
+    /// \param store Magazyn kolumnowy do zapisania.
+    /// \param out Strumie wyjciowy otwarty w trybie binarnym.
+    /// \throws std::runtime_error Gdy zapis si nie powiedzie.
+    static void save(const ColumnStore& store, std::ostream& out);
+
+    /// \brief Wczytuje magazyn ze strumienia.
+    /// \param in Strumie wejciowy otwarty w trybie binarnym.
+    /// \param[out] store Magazyn, ktrego zawarto zostanie zastpiona danymi z migawki.
+    /// \throws std::runtime_error Gdy plik jest uszkodzony, ma inn wersj lub kolejno bajtw.
+    static void load(std::istream& in, ColumnStore& store);
+
+    /// \brief Oblicza sum kontroln CRC32 (wielomian IEEE 802.3).
+    /// \param data Wskanik na dane.
+    /// \param size Rozmiar danych w bajtach.
+    /// \param crc Warto pocztkowa, pozwalajca liczy sum dla danych podzielonych na czci.
+    /// \return Suma kontrolna.
+    static uint32_t crc32(const void* data, size_t size, uint32_t crc = 0);
+};
+
+#endif // SNAPSHOT_H
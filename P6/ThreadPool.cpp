@@ -0,0 +1,162 @@
+/// \file ThreadPool.cpp
+/// \brief Implementacja puli wtkw z podkradaniem zada.
+
+#include "ThreadPool.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+/// \brief Czy biecy wtek wykonuje wanie zadania ktrej puli (zagniedone wywoania s wtedy szeregowe).
+static thread_local bool insideThreadPool = false;
+
+/// \brief Tworzy pul.
+ThreadPool::ThreadPool(unsigned threadCount)
+    : currentTask(nullptr), failed(false), generation(0), busyWorkers(0), stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    ranges.reset(new std::atomic<uint64_t>[threadCount]);
+    for (unsigned participant = 0; participant < threadCount; ++participant) {
+        ranges[participant].store(0, std::memory_order_relaxed);
+    }
+    for (unsigned participant = 1; participant < threadCount; ++participant) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, participant);
+    }
+}
+
+/// \brief Zatrzymuje i docza wtki puli.
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/// \brief Wykonuje zadania o numerach 0..taskCount-1 i czeka na ich zakoczenie.
+void ThreadPool::parallelFor(size_t taskCount, const Task& task) {
+    if (taskCount > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Zbyt wiele zada dla puli wtkw");
+    }
+
+    std::unique_lock<std::mutex> callerLock(callerMutex, std::defer_lock);
+    if (taskCount < 2 || workers.empty() || insideThreadPool || !callerLock.try_lock()) {
+        for (size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex) {
+            task(taskIndex);  ///< Wykonanie szeregowe
+        }
+        return;
+    }
+
+    // Podzia zada na rwne, cige zakresy
+    const uint64_t participants = size();
+    for (uint64_t participant = 0; participant < participants; ++participant) {
+        uint64_t begin = taskCount * participant / participants;
+        uint64_t end = taskCount * (participant + 1) / participants;
+        ranges[participant].store(begin << 32 | end, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        failed.store(false, std::memory_order_relaxed);
+        failure = nullptr;
+        busyWorkers = workers.size();
+        ++generation;
+    }
+    wake.notify_all();
+
+    runTasks(0);  ///< Wtek wywoujcy wykonuje pierwszy zakres
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return busyWorkers == 0; });
+    currentTask = nullptr;
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+/// \brief Zwraca wspln pul programu, z liczb wtkw rwn liczbie rdzeni procesora.
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+/// \brief Ptla wtku puli: czeka na kolejne wywoanie parallelFor i wykonuje jego zadania.
+void ThreadPool::workerLoop(unsigned participant) {
+    uint64_t seen = 0;  ///< Numer ostatniego obsuonego wywoania
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runTasks(participant);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+/// \brief Wykonuje zadania z wasnego zakresu, a nastpnie podkrada je z zakresw pozostaych wtkw.
+void ThreadPool::runTasks(unsigned participant) {
+    insideThreadPool = true;
+    const unsigned participants = size();
+    size_t taskIndex;
+    for (unsigned offset = 0; offset < participants; ++offset) {
+        unsigned slot = (participant + offset) % participants;
+        while (offset == 0 ? takeFront(slot, taskIndex) : takeBack(slot, taskIndex)) {
+            if (failed.load(std::memory_order_relaxed)) {
+                continue;  ///< Po bdzie zadania s tylko zdejmowane z zakresw
+            }
+            try {
+                (*currentTask)(taskIndex);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+    insideThreadPool = false;
+}
+
+/// \brief Pobiera zadanie z pocztku zakresu.
+bool ThreadPool::takeFront(unsigned slot, size_t& taskIndex) {
+    uint64_t range = ranges[slot].load(std::memory_order_relaxed);
+    for (;;) {
+        uint64_t begin = range >> 32, end = range & 0xFFFFFFFFu;
+        if (begin >= end) {
+            return false;
+        }
+        if (ranges[slot].compare_exchange_weak(range, (begin + 1) << 32 | end, std::memory_order_relaxed)) {
+            taskIndex = static_cast<size_t>(begin);
+            return true;
+        }
+    }
+}
+
+/// \brief Podkrada zadanie z koca zakresu.
+bool ThreadPool::takeBack(unsigned slot, size_t& taskIndex) {
+    uint64_t range = ranges[slot].load(std::memory_order_relaxed);
+    for (;;) {
+        uint64_t begin = range >> 32, end = range & 0xFFFFFFFFu;
+        if (begin >= end) {
+            return false;
+        }
+        if (ranges[slot].compare_exchange_weak(range, begin << 32 | (end - 1), std::memory_order_relaxed)) {
+            taskIndex = static_cast<size_t>(end - 1);
+            return true;
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/// \file ThreadPool.h
+/// \brief Deklaracja klasy ThreadPool - puli wtkw z podkradaniem zada.
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// \class ThreadPool
+/// \brief Pula wtkw wykonujca ponumerowane zadania rwnolegle (parallelFor).
+/// Zadania 0..n-1 s dzielone na cige zakresy, po jednym na wtek. Wtek bierze zadania z pocztku wasnego
+/// zakresu, a gdy go wyczerpie - podkrada pojedyncze zadania z koca zakresw pozostaych wtkw. Zakres jest
+/// zapisany w jednej zmiennej atomowej, wic zarwno pobieranie, jak i podkradanie odbywa si bez blokad.
+/// Wtek wywoujcy parallelFor sam rwnie wykonuje zadania.
+class ThreadPool {
+public:
+    using Task = std::function<void(size_t)>; ///< Zadanie otrzymujce swj numer.
+
+    /// \brief Tworzy pul.
+    /// \param threadCount czna liczba wtkw wykonujcych zadania, razem z wywoujcym (0 - liczba rdzeni procesora).
+    explicit ThreadPool(unsigned threadCount = 0);
+
+    /// \brief Zatrzymuje i docza wtki puli.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// \brief Zwraca czn liczb wtkw wykonujcych zadania (wtki puli i wtek wywoujcy).
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    /// \brief Wykonuje zadania o numerach 0..taskCount-1 i czeka na ich zakoczenie.
+    /// \param taskCount Liczba zada.
+    /// \param task Funkcja wywoywana dla kadego numeru zadania, wspbienie z wielu wtkw.
+    /// \throws std::invalid_argument Jeli liczba zada nie mieci si w 32 bitach.
+    /// \details Kolejno wykonania zada nie jest okrelona; wyniki naley zapisywa pod numerem zadania.
+    /// Pierwszy wyjtek rzucony przez zadanie jest przekazywany wywoujcemu, a pozostae zadania s pomijane.
+    /// Wywoanie z wntrza zadania albo w czasie, gdy pula jest zajta przez inny wtek, wykonuje zadania
+    /// szeregowo w wtku wywoujcym.
+    void parallelFor(size_t taskCount, const Task& task);
+
+    /// \brief Zwraca wspln pul programu, z liczb wtkw rwn liczbie rdzeni procesora.
+    static ThreadPool& shared();
+
+private:
+    /// \brief Ptla wtku puli: czeka na kolejne wywoanie parallelFor i wykonuje jego zadania.
+    /// \param participant Numer wtku (1..size()-1; 0 to wtek wywoujcy).
+    void workerLoop(unsigned participant);
+
+    /// \brief Wykonuje zadania z wasnego zakresu, a nastpnie podkrada je z zakresw pozostaych wtkw.
+    /// \param participant Numer wtku.
+    void runTasks(unsigned participant);
+
+    /// \brief Pobiera zadanie z pocztku zakresu.
+    /// \param slot Numer zakresu.
+    /// \param[out] taskIndex Numer pobranego zadania.
+    /// \return true, jeli zakres nie by pusty.
+    bool takeFront(unsigned slot, size_t& taskIndex);
+
+    /// \brief Podkrada zadanie z koca zakresu.
+    /// \param slot Numer zakresu.
+    /// \param[out] taskIndex Numer podkradzionego zadania.
+    /// \return true, jeli zakres nie by pusty.
+    bool takeBack(unsigned slot, size_t& taskIndex);
+
+    std::vector<std::thread> workers; ///< Wtki puli.
+    std::unique_ptr<std::atomic<uint64_t>[]> ranges; ///< Zakresy zada wtkw: pocztek w starszych, koniec w modszych 32 bitach.
+    const Task* currentTask; ///< Zadanie biecego wywoania parallelFor.
+    std::atomic<bool> failed; ///< Czy ktre zadanie rzucio wyjtek (pozostae s wtedy pomijane).
+    std::exception_ptr failure; ///< Pierwszy wyjtek rzucony przez zadanie.
+    std::mutex mutex; ///< Chroni stan wywoania (generation, busyWorkers, stopping, failure).
+    std::condition_variable wake; ///< Budzi wtki puli na pocztku wywoania.
+    std::condition_variable finished; ///< Sygnalizuje zakoczenie pracy wszystkich wtkw puli.
+    uint64_t generation; ///< Numer biecego wywoania parallelFor.
+    size_t busyWorkers; ///< Liczba wtkw puli, ktre nie zakoczyy jeszcze biecego wywoania.
+    bool stopping; ///< Czy pula jest zatrzymywana.
+    std::mutex callerMutex; ///< Zapewnia, e pula obsuguje naraz tylko jedno wywoanie parallelFor.
+};
+
+#endif // THREADPOOL_H
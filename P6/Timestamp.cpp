@@ -0,0 +1,124 @@
+/// \file Timestamp.cpp
+/// \brief Implementacja funkcji do konwersji dat na znaczniki czasu i odwrotnie.
+
+#include "Timestamp.h"
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+
+/// \brief Zamienia dat kalendarzow na liczb dni od 01.01.1970.
+/// \details Algorytm dziaa na kalendarzu gregoriaskim i nie korzysta z mktime, dziki czemu wynik
+/// nie zaley od strefy czasowej ani od zmiany czasu letniego.
+static int32_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2; ///< Rok liczony od marca, aby luty by ostatnim miesicem.
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/// \brief Zamienia liczb dni od 01.01.1970 na dat kalendarzow.
+static void civilFromDays(int32_t days, int& year, int& month, int& day) {
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const int dayOfEra = days - era * 146097;
+    const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int monthPart = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthPart + 2) / 5 + 1;
+    month = monthPart + (monthPart < 10 ? 3 : -9);
+    year = yearOfEra + era * 400 + (month <= 2);
+}
+
+/// \brief Zwraca liczb dni w miesicu z uwzgldnieniem lat przestpnych.
+static int daysInMonth(int year, int month) {
+    static const int lengths[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : lengths[month - 1];
+}
+
+/// \brief Wczytuje liczb zoon z co najwyej maxDigits cyfr.
+/// \return true, jeli wczytano przynajmniej jedn cyfr.
+static bool readNumber(const char*& it, const char* end, int maxDigits, int& value) {
+    value = 0;
+    int digits = 0;
+    while (it != end && digits < maxDigits && *it >= '0' && *it <= '9') {
+        value = value * 10 + (*it - '0');
+        ++it;
+        ++digits;
+    }
+    return digits > 0;
+}
+
+/// \brief Buduje znacznik czasu (minuty od 01.01.1970 00:00) z poszczeglnych skadowych daty.
+int32_t makeTimestamp(int year, int month, int day, int hour, int minute) {
+    return daysFromCivil(year, month, day) * 1440 + hour * 60 + minute;
+}
+
+/// \brief Rozkada znacznik czasu na rok, miesic, dzie, godzin i minut.
+void splitTimestamp(int32_t timestamp, int& year, int& month, int& day, int& hour, int& minute) {
+    int32_t days = timestamp / 1440;
+    int32_t minutes = timestamp % 1440;
+    if (minutes < 0) { ///< Korekta dla dat sprzed 1970 roku.
+        minutes += 1440;
+        --days;
+    }
+    civilFromDays(days, year, month, day);
+    hour = minutes / 60;
+    minute = minutes % 60;
+}
+
+/// \brief Parsuje dat w formacie dd.mm.yyyy hh:mm[:ss] z podanego zakresu znakw.
+/// \details Sekundy s pomijane - dane pomiarowe maj rozdzielczo minutow. Znacznik czasu jest liczony
+/// na 64 bitach, a daty, ktrych nie da si zapisa w int32 (po roku 6053), s odrzucane.
+bool parseTimestamp(const char* begin, const char* end, int32_t& timestamp) {
+    const char* it = begin;
+    int day, month, year, hour = 0, minute = 0, second = 0;
+
+    if (!readNumber(it, end, 2, day) || it == end || *it++ != '.') return false;
+    if (!readNumber(it, end, 2, month) || it == end || *it++ != '.') return false;
+    if (!readNumber(it, end, 4, year)) return false;
+
+    // Cz godzinowa jest opcjonalna - sama data oznacza pnoc.
+    if (it != end && *it == ' ') {
+        ++it;
+        if (!readNumber(it, end, 2, hour) || it == end || *it++ != ':') return false;
+        if (!readNumber(it, end, 2, minute)) return false;
+        if (it != end && *it == ':' && !readNumber(++it, end, 2, second)) return false;
+    }
+
+    // Dopuszczalne s jedynie biae znaki na kocu (np. '\r' z plikw Windows).
+    while (it != end && (*it == ' ' || *it == '\r' || *it == '\t')) ++it;
+    if (it != end) return false;
+
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) || hour > 23 || minute > 59
+        || second > 59) {
+        return false;
+    }
+
+    const int64_t minutes = static_cast<int64_t>(daysFromCivil(year, month, day)) * 1440 + hour * 60 + minute;
+    if (minutes < std::numeric_limits<int32_t>::min() || minutes > std::numeric_limits<int32_t>::max()) {
+        return false;
+    }
+    timestamp = static_cast<int32_t>(minutes);
+    return true;
+}
+
+/// \brief Parsuje dat w formacie dd.mm.yyyy hh:mm[:ss] i rzuca wyjtek, gdy format jest niepoprawny.
+int32_t parseTimestamp(const std::string& text) {
+    int32_t timestamp;
+    if (!parseTimestamp(text.data(), text.data() + text.size(), timestamp)) {
+        throw std::invalid_argument("Nieprawidowy format daty: " + text);
+    }
+    return timestamp;
+}
+
+/// \brief Formatuje znacznik czasu do postaci dd.mm.yyyy hh:mm.
+std::string formatTimestamp(int32_t timestamp) {
+    int year, month, day, hour, minute;
+    splitTimestamp(timestamp, year, month, day, hour, minute);
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%02d.%02d.%04d %02d:%02d", day, month, year, hour, minute);
+    return buffer;
+}
@@ -0,0 +1,48 @@
+/// \file Timestamp.h
+/// \brief Deklaracje funkcji do konwersji dat na znaczniki czasu i odwrotnie.
+
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <cstdint>
+#include <string>
+
+/// \brief Buduje znacznik czasu z poszczeglnych skadowych daty.
+/// \param year Rok (np. 2023).
+/// \param month Miesic (1-12).
+/// \param day Dzie miesica (1-31).
+/// \param hour Godzina (0-23).
+/// \param minute Minuta (0-59).
+/// \return Liczba minut od 01.01.1970 00:00, niezalena od strefy czasowej.
+int32_t makeTimestamp(int year, int month, int day, int hour, int minute);
+
+/// \brief Rozkada znacznik czasu na skadowe daty.
+/// \param timestamp Liczba minut od 01.01.1970 00:00.
+/// \param[out] year Rok.
+/// \param[out] month Miesic (1-12).
+/// \param[out] day Dzie miesica (1-31).
+/// \param[out] hour Godzina (0-23).
+/// \param[out] minute Minuta (0-59).
+void splitTimestamp(int32_t timestamp, int& year, int& month, int& day, int& hour, int& minute);
+
+/// \brief Parsuje dat w formacie dd.mm.yyyy hh:mm[:ss] bez tworzenia tymczasowych obiektw.
+/// \param begin Wskanik na pocztek tekstu daty.
+/// \param end Wskanik za kocem tekstu daty.
+/// \param[out] timestamp Wynikowa liczba minut od 01.01.1970 00:00.
+/// \return true, jeli data jest poprawna, false w przeciwnym razie.
+/// Sekundy s pomijane, a godzina moe by zapisana jedn cyfr (np. "01.10.2020 0:15"). Niepoprawne s dni
+/// spoza dugoci miesica (np. 31.02) oraz daty poza zakresem znacznika int32 (mniej wicej lata 0-6053).
+bool parseTimestamp(const char* begin, const char* end, int32_t& timestamp);
+
+/// \brief Parsuje dat w formacie dd.mm.yyyy hh:mm[:ss].
+/// \param text Data w formacie tekstowym.
+/// \return Liczba minut od 01.01.1970 00:00.
+/// \throws std::invalid_argument Gdy tekst nie jest poprawn dat.
+int32_t parseTimestamp(const std::string& text);
+
+/// \brief Formatuje znacznik czasu do postaci dd.mm.yyyy hh:mm.
+/// \param timestamp Liczba minut od 01.01.1970 00:00.
+/// \return Data w formacie tekstowym, zgodnym z formatem dat podawanych przez uytkownika.
+std::string formatTimestamp(int32_t timestamp);
+
+#endif // TIMESTAMP_H
@@ -2,75 +2,379 @@
 /// \brief Implementacja klasy TreeData do przechowywania i analizy danych w strukturze drzewa.
 
 #include "TreeData.h"
+#include "Snapshot.h"
+#include "IndexFile.h"
+#include "AggregateKernels.h"
+#include <algorithm>
 #include <iostream>
-#include <sstream>
-#include <iomanip>
-#include <ctime>
+#include <limits>
+#include <stdexcept>
 
 using namespace std;
 
+/// \brief Konstruktor drzewa.
+/// \param resource Zasb pamici, z ktrego przydzielane s wzy kalendarza.
+TreeData::TreeData(std::pmr::memory_resource* resource) : years(resource) {
+}
+
 /// \brief Dodaje dane do struktury drzewa.
 /// \param rowData Obiekt RowData reprezentujcy dane wiersza.
 /// \details Funkcja ta przetwarza dane z obiektu RowData i dodaje je do odpowiedniej lokalizacji w strukturze drzewa,
 /// w zalenoci od daty, godziny, minuty oraz kwartau. Uywane s dane o roku, miesicu, dniu, godzinie i minucie,
 /// aby odpowiednio wstawi dane do hierarchii.
 void TreeData::addData(const RowData& rowData) {
-    // Tworzenie strumienia z dat z obiektu RowData
-    stringstream ss(rowData.getDate());
-    string token;
-    vector<int> dateParts;
+    addToNodes(rowData);  ///< Aktualizacja wzw kalendarza i ich statystyk
+    size_t index = store.insert(rowData);  ///< Dodanie wiersza do magazynu kolumnowego
+    prefixSums.insert(store, index);  ///< Aktualizacja indeksu sum prefiksowych
+}
+
+/// \brief Dodaje wiersz, jeli drzewo nie zawiera jeszcze wiersza o tym samym znaczniku czasu.
+/// \param rowData Wiersz danych do dodania.
+/// \return true, jeli wiersz zosta dodany, false jeli by duplikatem.
+bool TreeData::addDataUnique(const RowData& rowData) {
+    int32_t timestamp = rowData.getTimestamp();
+    if (!store.empty() && timestamp <= store.timestampAt(store.size() - 1)) {
+        size_t index = store.lowerBound(timestamp);  ///< Wyszukanie binarne tylko dla wierszy spoza koca serii
+        if (index < store.size() && store.timestampAt(index) == timestamp) {
+            return false;
+        }
+    }
+    addData(rowData);
+    return true;
+}
+
+/// \brief Zapisuje wiersze paczki w kolumnach magazynu, poczwszy od podanej pozycji.
+/// \param rows Wiersze paczki.
+/// \param count Liczba wierszy.
+/// \param target Magazyn o rozmiarze co najmniej position + count.
+/// \param position Pozycja pierwszego zapisywanego wiersza.
+static void copyBatchRows(const RowData* rows, size_t count, ColumnStore& target, size_t position) {
+    int32_t* timestamps = target.mutableTimestamps() + position;
+    for (size_t i = 0; i < count; ++i) {
+        timestamps[i] = rows[i].getTimestamp();
+    }
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        float* values = target.mutableColumn(static_cast<Channel>(channel)) + position;
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = rows[i].getValue(static_cast<Channel>(channel));
+        }
+    }
+}
+
+/// \brief Dodaje paczk wierszy.
+/// \param rows Wskanik na pierwszy wiersz paczki.
+/// \param count Liczba wierszy.
+/// \param skipDuplicates true, jeli pomijane maj by powtrzone znaczniki czasu.
+/// \return Liczba dodanych wierszy.
+size_t TreeData::addBatch(const RowData* rows, size_t count, bool skipDuplicates) {
+    auto earlier = [](const RowData& left, const RowData& right) { return left.getTimestamp() < right.getTimestamp(); };
+    std::vector<RowData> prepared;  ///< Kopia paczki, tworzona tylko gdy trzeba j posortowa lub odfiltrowa
+    const RowData* batch = rows;
+    if (!std::is_sorted(rows, rows + count, earlier)) {
+        prepared.assign(rows, rows + count);
+        std::stable_sort(prepared.begin(), prepared.end(), earlier);  ///< Rwne znaczniki czasu zachowuj kolejno
+        batch = prepared.data();
+    }
+    if (skipDuplicates) {
+        std::vector<RowData> unique;
+        unique.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            int32_t timestamp = batch[i].getTimestamp();
+            if (!unique.empty() && unique.back().getTimestamp() == timestamp) continue;
+            if (!store.empty() && timestamp <= store.timestampAt(store.size() - 1)) {
+                size_t index = store.lowerBound(timestamp);
+                if (index < store.size() && store.timestampAt(index) == timestamp) continue;
+            }
+            unique.push_back(batch[i]);
+        }
+        prepared.swap(unique);
+        batch = prepared.data();
+        count = prepared.size();
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    size_t oldSize = store.size();
+    size_t changedFrom;  ///< Pierwsza pozycja magazynu, ktrej zawarto si zmienia
+    if (oldSize == 0 || batch[0].getTimestamp() >= store.timestampAt(oldSize - 1)) {
+        // Paczka nowsza od danych drzewa - dopisanie na koniec kolumn
+        store.resize(oldSize + count);
+        copyBatchRows(batch, count, store, oldSize);
+        addRangeToNodes(store, oldSize, oldSize + count);
+        changedFrom = oldSize;
+    }
+    else {
+        // Scalanie od koca: kady wiersz magazynu przesuwany jest co najwyej raz
+        ColumnStore batchStore;
+        batchStore.resize(count);
+        copyBatchRows(batch, count, batchStore, 0);
+        addRangeToNodes(batchStore, 0, count);
+
+        changedFrom = store.upperBound(batch[0].getTimestamp());
+        store.resize(oldSize + count);
+        int32_t* timestamps = store.mutableTimestamps();
+        float* values[CHANNEL_COUNT];
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            values[channel] = store.mutableColumn(static_cast<Channel>(channel));
+        }
+        size_t existing = oldSize, added = count, write = oldSize + count;
+        while (added > 0) {
+            --write;
+            if (existing > 0 && timestamps[existing - 1] > batch[added - 1].getTimestamp()) {
+                --existing;
+                timestamps[write] = timestamps[existing];
+                for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                    values[channel][write] = values[channel][existing];
+                }
+            }
+            else {
+                --added;
+                timestamps[write] = batch[added].getTimestamp();
+                for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                    values[channel][write] = batch[added].getValue(static_cast<Channel>(channel));
+                }
+            }
+        }
+    }
+    prefixSums.insertRange(store, changedFrom);  ///< Przeliczenie sum od pierwszej zmienionej pozycji
+    return count;
+}
+
+/// \brief Zwraca liczb wierszy przechowywanych w drzewie.
+size_t TreeData::size() const {
+    return store.size();
+}
+
+/// \brief Zapisuje dane drzewa do strumienia w formacie migawki.
+/// \param out Strumie wyjciowy otwarty w trybie binarnym.
+/// \details Kolumny magazynu s zapisywane hurtowo, kada jednym wywoaniem write.
+void TreeData::saveSnapshot(std::ostream& out) const {
+    Snapshot::save(store, out);
+}
+
+/// \brief Zastpuje dane drzewa zawartoci migawki.
+/// \param in Strumie wejciowy otwarty w trybie binarnym.
+/// \details Kolumny s wczytywane bezporednio do magazynu (jedna alokacja na kolumn), po czym wzy kalendarza
+/// i indeks sum prefiksowych s odbudowywane jednym przebiegiem po posortowanych wierszach.
+void TreeData::loadSnapshot(std::istream& in) {
+    years.clear();
+    prefixSums.clear();
+    Snapshot::load(in, store);
+    rebuildIndexes();
+}
+
+/// \brief Zapisuje dane drzewa do pliku indeksu.
+/// \param path cieka do pliku indeksu.
+/// \details Obok kolumn i sum prefiksowych zapisywane s statystyki zbiorcze wszystkich kwartaw, dni
+/// i miesicy w kolejnoci chronologicznej.
+void TreeData::saveIndex(const std::string& path) {
+    store.detach();  ///< Zwolnienie odwzorowania indeksu, ktry moe by wanie podmieniany
+    prefixSums.detach();
+
+    std::vector<RollupRecord> quarterRecords, dayRecords, monthRecords;
+    for (const auto& yearPair : years) {
+        const YearNode& yearNode = yearPair.second;
+        for (const MonthNode& monthNode : yearNode.months) {
+            if (!yearNode.monthOccupied.test(monthNode.month - 1)) continue;
+            monthRecords.push_back(RollupRecord::fromAggregate(yearNode.start + monthNode.firstDay * 1440, monthNode.stats));
+            for (int dayIndex = monthNode.firstDay; dayIndex < monthNode.firstDay + monthNode.dayCount; ++dayIndex) {
+                if (!yearNode.dayOccupied.test(dayIndex)) continue;
+                int32_t dayStart = yearNode.start + dayIndex * 1440;
+                dayRecords.push_back(RollupRecord::fromAggregate(dayStart, yearNode.days[dayIndex].stats));
+                for (int quarter = 0; quarter < YearNode::QUARTERS_PER_DAY; ++quarter) {
+                    int slot = dayIndex * YearNode::QUARTERS_PER_DAY + quarter;
+                    if (!yearNode.quarterOccupied.test(slot)) continue;
+                    quarterRecords.push_back(RollupRecord::fromAggregate(dayStart + quarter * 360, yearNode.quarters[slot].stats));
+                }
+            }
+        }
+    }
+    IndexFile::write(path, store, prefixSums, quarterRecords, dayRecords, monthRecords);
+}
+
+/// \brief Zastpuje dane drzewa plikiem indeksu odwzorowanym w pamici.
+/// \param path cieka do pliku indeksu.
+/// \return true, jeli indeks zosta otwarty; false, jeli plik nie istnieje.
+/// \details Magazyn i indeks sum prefiksowych wspdziel wasno odwzorowanego pliku, wic pozostaje on
+/// otwarty tak dugo, jak dugo dane s z niego czytane.
+bool TreeData::openIndex(const std::string& path) {
+    std::shared_ptr<IndexFile> index = std::make_shared<IndexFile>();
+    if (!index->open(path)) {
+        return false;
+    }
+
+    const float* columns[CHANNEL_COUNT];
+    const double* prefixes[CHANNEL_COUNT];
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        columns[channel] = index->column(static_cast<Channel>(channel));
+        prefixes[channel] = index->prefixSums(static_cast<Channel>(channel));
+    }
+    store.attach(index->timestamps(), columns, index->rowCount(), index);
+    prefixSums.attach(prefixes, index->rowCount() + 1, index);
 
-    // Rozdzielenie daty na poszczeglne czci (dzie, miesic, rok)
-    while (getline(ss, token, '.')) {
-        dateParts.push_back(stoi(token));  ///< Parsowanie kadej czci daty na liczb
+    // Wzy kalendarza odtwarzane z zapisanych statystyk - pozycja okresu w tablicach roku wynika z jego pocztku
+    years.clear();
+    int year, month, day, hour, minute;
+    for (size_t i = 0; i < index->monthCount(); ++i) {
+        const RollupRecord& record = index->months()[i];
+        splitTimestamp(record.start, year, month, day, hour, minute);
+        YearNode& node = yearNode(year);
+        node.monthOccupied.set(month - 1);
+        node.months[month - 1].stats = record.toAggregate();
+        node.stats.merge(node.months[month - 1].stats);
     }
+    for (size_t i = 0; i < index->dayCount(); ++i) {
+        const RollupRecord& record = index->days()[i];
+        splitTimestamp(record.start, year, month, day, hour, minute);
+        YearNode& node = yearNode(year);
+        int dayIndex = (record.start - node.start) / 1440;
+        node.dayOccupied.set(dayIndex);
+        node.days[dayIndex].day = day;
+        node.days[dayIndex].stats = record.toAggregate();
+    }
+    for (size_t i = 0; i < index->quarterCount(); ++i) {
+        const RollupRecord& record = index->quarters()[i];
+        splitTimestamp(record.start, year, month, day, hour, minute);
+        YearNode& node = yearNode(year);
+        int slot = (record.start - node.start) / 360;
+        QuarterNode& quarterNode = node.quarters[slot];
+        node.quarterOccupied.set(slot);
+        quarterNode.quarter = slot % YearNode::QUARTERS_PER_DAY;
+        quarterNode.hour = hour;
+        quarterNode.minute = minute;
+        quarterNode.stats = record.toAggregate();
+    }
+    return true;
+}
+
+/// \brief Zwraca wze roku, tworzc go (wraz z ukadem miesicy) przy pierwszym uyciu.
+/// \param year Rok.
+/// \details Nowy wze dostaje pocztek i koniec roku oraz pooenie kadego miesica w tablicy dni,
+/// wic pniejsze wstawianie wierszy nie wymaga ju oblicze kalendarzowych.
+TreeData::YearNode& TreeData::yearNode(int year) {
+    auto inserted = years.try_emplace(year);
+    YearNode& node = inserted.first->second;
+    if (inserted.second) {
+        node.year = year;
+        node.start = makeTimestamp(year, 1, 1, 0, 0);
+        int32_t monthStart = node.start;
+        for (int month = 1; month <= 12; ++month) {
+            int32_t monthEnd = month == 12 ? makeTimestamp(year + 1, 1, 1, 0, 0) : makeTimestamp(year, month + 1, 1, 0, 0);
+            MonthNode& monthNode = node.months[month - 1];
+            monthNode.month = month;
+            monthNode.firstDay = (monthStart - node.start) / 1440;
+            monthNode.dayCount = (monthEnd - monthStart) / 1440;
+            monthStart = monthEnd;
+        }
+        node.end = monthStart;
+    }
+    return node;
+}
+
+/// \brief Odbudowuje wzy kalendarza i indeks sum prefiksowych na podstawie magazynu.
+void TreeData::rebuildIndexes() {
+    years.clear();
+    addRangeToNodes(store, 0, store.size());
+    prefixSums.rebuild(store);
+}
 
+/// \brief Dodaje wiersz do wzw kalendarza i aktualizuje ich statystyki zbiorcze.
+/// \param rowData Obiekt RowData reprezentujcy dane wiersza.
+void TreeData::addToNodes(const RowData& rowData) {
     // Zmienne dla roku, miesica, dnia, godziny, minuty oraz kwartau
-    int year = dateParts[2];  ///< Rok wycignity z daty
-    int month = dateParts[1];  ///< Miesic wycignity z daty
-    int day = dateParts[0];    ///< Dzie wycignity z daty
-    int hour = stoi(rowData.getDate().substr(11, 2));  ///< Godzina wycignita z daty
-    int minute = stoi(rowData.getDate().substr(14, 2));  ///< Minuta wycignita z daty
+    int year, month, day, hour, minute;
+    splitTimestamp(rowData.getTimestamp(), year, month, day, hour, minute);  ///< Rozkad znacznika czasu na skadowe daty
     int quarter = (hour * 60 + minute) / 360;  ///< Wyliczanie kwartau na podstawie godziny i minuty
 
-    // Przypisanie wartoci do struktury drzewa na podstawie wyodrbnionych danych
-    years[year].year = year;  ///< Ustawienie roku w strukturze
-    years[year].months[month].month = month;  ///< Ustawienie miesica w strukturze
-    years[year].months[month].days[day].day = day;  ///< Ustawienie dnia w strukturze
-    years[year].months[month].days[day].quarters[quarter].quarter = quarter;  ///< Ustawienie kwartau w strukturze
-    years[year].months[month].days[day].quarters[quarter].hour = hour;  ///< Ustawienie godziny w strukturze
-    years[year].months[month].days[day].quarters[quarter].minute = minute;  ///< Ustawienie minuty w strukturze
-    years[year].months[month].days[day].quarters[quarter].data.push_back(rowData);  ///< Dodanie danych do kwartau
+    // Pozycje w tablicach roku wynikaj z odlegoci od pocztku roku
+    YearNode& node = yearNode(year);
+    int dayIndex = (rowData.getTimestamp() - node.start) / 1440;  ///< Numer dnia w roku
+    Aggregate part;
+    part.add(rowData);
+    addToQuarter(node, month, day, dayIndex, quarter, part);
+}
+
+/// \brief Dodaje do wzw kalendarza wiersze magazynu z pozycji [first, last), uporzdkowane chronologicznie.
+void TreeData::addRangeToNodes(const ColumnStore& source, size_t first, size_t last) {
+    YearNode* node = nullptr;  ///< Wze roku poprzedniego kwartau
+    size_t begin = first;
+    while (begin < last) {
+        int32_t timestamp = source.timestampAt(begin);
+        int year, month, day, hour, minute;
+        splitTimestamp(timestamp, year, month, day, hour, minute);
+        if (node == nullptr || node->year != year) {
+            node = &yearNode(year);  ///< Wyszukanie w mapie lat tylko przy zmianie roku
+        }
+        int dayIndex = (timestamp - node->start) / 1440;
+        int quarter = (hour * 60 + minute) / 360;
+        int32_t quarterEnd = node->start + dayIndex * 1440 + (quarter + 1) * 360;
+
+        size_t end = begin + 1;  ///< Koniec cigu wierszy tego samego kwartau
+        while (end < last && source.timestampAt(end) < quarterEnd) {
+            ++end;
+        }
+        Aggregate part;
+        AggregateKernels::aggregate(source, begin, end, part);
+        addToQuarter(*node, month, day, dayIndex, quarter, part);
+        begin = end;
+    }
+}
+
+/// \brief Docza statystyk wierszy jednego kwartau do wzw kalendarza.
+void TreeData::addToQuarter(YearNode& node, int month, int day, int dayIndex, int quarter, const Aggregate& part) {
+    int slot = dayIndex * YearNode::QUARTERS_PER_DAY + quarter;  ///< Numer kwartau w roku
+    MonthNode& monthNode = node.months[month - 1];
+    DayNode& dayNode = node.days[dayIndex];
+    QuarterNode& quarterNode = node.quarters[slot];
+    node.monthOccupied.set(month - 1);  ///< Oznaczenie miesica jako zajtego
+    node.dayOccupied.set(dayIndex);  ///< Oznaczenie dnia jako zajtego
+    node.quarterOccupied.set(slot);  ///< Oznaczenie kwartau jako zajtego
+    dayNode.day = day;  ///< Ustawienie dnia w strukturze
+    quarterNode.quarter = quarter;  ///< Ustawienie kwartau w strukturze
+    quarterNode.hour = quarter * 6;  ///< Godzina rozpoczcia kwartau
+    quarterNode.minute = 0;  ///< Kwartay zaczynaj si o penej godzinie
+
+    // Przyrostowa aktualizacja statystyk zbiorczych na kadym poziomie drzewa
+    node.stats.merge(part);
+    monthNode.stats.merge(part);
+    dayNode.stats.merge(part);
+    quarterNode.stats.merge(part);
 }
 
 /// \brief Wywietla zawarto drzewa na standardowym wyjciu.
 /// \details Funkcja ta rekurencyjnie przeglda wszystkie elementy drzewa, poczwszy od lat, przez miesice, dni,
 /// kwartay, a po same dane. Wypisuje wszystkie dostpne dane z poszczeglnych wzw.
 void TreeData::print() const {
+    size_t row = 0;  ///< Pozycja biecego wiersza w magazynie - drzewo i kolumny s uporzdkowane tak samo
+
     // Iterowanie po wszystkich latach w drzewie
     for (const auto& yearPair : years) {
         const YearNode& yearNode = yearPair.second;  ///< Pobieranie wza roku
         cout << "Year: " << yearNode.year << endl;  ///< Wypisanie roku
 
-        // Iterowanie po wszystkich miesicach w danym roku
-        for (const auto& monthPair : yearNode.months) {
-            const MonthNode& monthNode = monthPair.second;  ///< Pobieranie wza miesica
+        // Iterowanie po zajtych miesicach w danym roku
+        for (const MonthNode& monthNode : yearNode.months) {
+            if (!yearNode.monthOccupied.test(monthNode.month - 1)) continue;
             cout << "\tMonth: " << monthNode.month << endl;  ///< Wypisanie miesica
 
-            // Iterowanie po dniach w danym miesicu
-            for (const auto& dayPair : monthNode.days) {
-                const DayNode& dayNode = dayPair.second;  ///< Pobieranie wza dnia
+            // Iterowanie po zajtych dniach w danym miesicu
+            for (int dayIndex = monthNode.firstDay; dayIndex < monthNode.firstDay + monthNode.dayCount; ++dayIndex) {
+                if (!yearNode.dayOccupied.test(dayIndex)) continue;
+                const DayNode& dayNode = yearNode.days[dayIndex];  ///< Pobieranie wza dnia
                 cout << "\t\tDay: " << dayNode.day << endl;  ///< Wypisanie dnia
 
-                // Iterowanie po kwartaach w danym dniu
-                for (const auto& quarterPair : dayNode.quarters) {
-                    const QuarterNode& quarterNode = quarterPair.second;  ///< Pobieranie wza kwartau
+                // Iterowanie po zajtych kwartaach w danym dniu
+                for (int slot = dayIndex * YearNode::QUARTERS_PER_DAY; slot < (dayIndex + 1) * YearNode::QUARTERS_PER_DAY; ++slot) {
+                    if (!yearNode.quarterOccupied.test(slot)) continue;
+                    const QuarterNode& quarterNode = yearNode.quarters[slot];  ///< Pobieranie wza kwartau
                     cout << "\t\t\tQuarter: " << quarterNode.quarter
                         << " (Hour: " << quarterNode.hour << ", Minute: " << quarterNode.minute << ")" << endl;  ///< Wypisanie kwartau, godziny i minuty
 
                     // Wypisanie danych przypisanych do tego kwartau
-                    for (const auto& rowData : quarterNode.data) {
-                        rowData.displayData();  ///< Wywoanie metody wypisujcej dane z RowData
+                    int32_t quarterEnd = yearNode.start + (slot + 1) * 360;
+                    for (; row < store.size() && store.timestampAt(row) < quarterEnd; ++row) {
+                        store.rowAt(row).displayData();  ///< Wywoanie metody wypisujcej dane z RowData
                     }
                 }
             }
@@ -82,49 +386,20 @@ void TreeData::print() const {
 /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
 /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
 /// \return Wektor obiektw RowData w podanym przedziale czasowym.
-/// \details Funkcja ta iteruje po wszystkich danych w strukturze drzewa, porwnujc daty i zwracajc dane
-/// znajdujce si w podanym przedziale czasowym.
+/// \details Funkcja ta kopiuje do wektora wiersze widoku zwracanego przez viewBetweenDates().
 std::vector<RowData> TreeData::getDataBetweenDates(const std::string& startDate, const std::string& endDate) const {
-    std::vector<RowData> result;  ///< Wektor do przechowywania wynikw
-
-    // Konwersja daty pocztkowej na struktur tm
-    std::tm tm = {};
-    std::istringstream ss(startDate);
-    ss >> std::get_time(&tm, "%d.%m.%Y %H:%M");  ///< Wczytanie daty pocztkowej
-    time_t start = mktime(&tm);  ///< Konwersja na typ time_t
-
-    // Konwersja daty kocowej na struktur tm
-    ss.clear();  ///< Czyszczenie strumienia
-    ss.str(endDate);  ///< Ustawienie strumienia na dat kocow
-    ss >> std::get_time(&tm, "%d.%m.%Y %H:%M");  ///< Wczytanie daty kocowej
-    time_t end = mktime(&tm);  ///< Konwersja na typ time_t
-
-    // Iterowanie po wszystkich latach w drzewie
-    for (const auto& yearPair : years) {
-        const YearNode& yearNode = yearPair.second;  ///< Pobieranie wza roku
-        for (const auto& monthPair : yearNode.months) {
-            const MonthNode& monthNode = monthPair.second;  ///< Pobieranie wza miesica
-            for (const auto& dayPair : monthNode.days) {
-                const DayNode& dayNode = dayPair.second;  ///< Pobieranie wza dnia
-                for (const auto& quarterPair : dayNode.quarters) {
-                    const QuarterNode& quarterNode = quarterPair.second;  ///< Pobieranie wza kwartau
-                    for (const auto& rowData : quarterNode.data) {
-                        std::tm tm = {};
-                        std::istringstream ss(rowData.getDate());
-                        ss >> std::get_time(&tm, "%d.%m.%Y %H:%M");  ///< Wczytanie daty z danych
-                        time_t dataTime = mktime(&tm);  ///< Konwersja na typ time_t
-
-                        // Porwnanie czasu danych z przedziaem czasowym
-                        if (dataTime >= start && dataTime <= end) {
-                            result.push_back(rowData);  ///< Dodanie danych do wynikw, jeli mieszcz si w przedziale
-                        }
-                    }
-                }
-            }
-        }
-    }
+    return viewBetweenDates(startDate, endDate).toVector();
+}
 
-    return result;  ///< Zwrcenie wynikw
+/// \brief Zwraca widok na wiersze w okrelonym przedziale czasowym, bez kopiowania danych.
+/// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+/// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+/// \details Granice przedziau s wyszukiwane binarnie w kolumnie znacznikw czasu.
+RangeView TreeData::viewBetweenDates(const std::string& startDate, const std::string& endDate) const {
+    // Wyszukanie binarne pierwszego i ostatniego wiersza w przedziale
+    size_t first, last;
+    findRange(startDate, endDate, first, last);
+    return RangeView(store, first, last);
 }
 
 /// \brief Oblicza sumy wartoci w okrelonym przedziale czasowym.
@@ -135,27 +410,20 @@ std::vector<RowData> TreeData::getDataBetweenDates(const std::string& startDate,
 /// \param[out] importSum Suma importu.
 /// \param[out] consumptionSum Suma poboru.
 /// \param[out] productionSum Suma produkcji.
-/// \details Funkcja ta przetwarza dane w okrelonym przedziale czasowym i oblicza sumy dla poszczeglnych
-/// parametrw: autokonsumpcji, eksportu, importu, poboru i produkcji.
+/// \details Funkcja ta wyznacza binarnie zakres wierszy w przedziale i odczytuje sumy dla poszczeglnych
+/// parametrw (autokonsumpcji, eksportu, importu, poboru i produkcji) z indeksu sum prefiksowych w czasie O(log n).
 void TreeData::calculateSumsBetweenDates(const std::string& startDate, const std::string& endDate,
     float& selfConsumptionSum, float& exportSum, float& importSum,
     float& consumptionSum, float& productionSum) const {
-    // Inicjalizacja sum na 0
-    selfConsumptionSum = 0.0f;
-    exportSum = 0.0f;
-    importSum = 0.0f;
-    consumptionSum = 0.0f;
-    productionSum = 0.0f;
+    size_t first, last;
+    findRange(startDate, endDate, first, last);  ///< Wyszukanie binarne zakresu wierszy
 
-    // Pobranie danych w podanym przedziale czasowym
-    std::vector<RowData> data = getDataBetweenDates(startDate, endDate);
-    for (const auto& rowData : data) {
-        selfConsumptionSum += rowData.getSelfConsumption();  ///< Dodanie wartoci autokonsumpcji
-        exportSum += rowData.getExport();  ///< Dodanie wartoci eksportu
-        importSum += rowData.getImport();  ///< Dodanie wartoci importu
-        consumptionSum += rowData.getConsumption();  ///< Dodanie wartoci poboru
-        productionSum += rowData.getProduction();  ///< Dodanie wartoci produkcji
-    }
+    // Sumy odczytywane z indeksu sum prefiksowych - bez przegldania wierszy
+    selfConsumptionSum = static_cast<float>(prefixSums.sum(Channel::SelfConsumption, first, last));  ///< Suma autokonsumpcji
+    exportSum = static_cast<float>(prefixSums.sum(Channel::Export, first, last));  ///< Suma eksportu
+    importSum = static_cast<float>(prefixSums.sum(Channel::Import, first, last));  ///< Suma importu
+    consumptionSum = static_cast<float>(prefixSums.sum(Channel::Consumption, first, last));  ///< Suma poboru
+    productionSum = static_cast<float>(prefixSums.sum(Channel::Production, first, last));  ///< Suma produkcji
 }
 
 /// \brief Oblicza rednie wartoci w okrelonym przedziale czasowym.
@@ -166,32 +434,397 @@ void TreeData::calculateSumsBetweenDates(const std::string& startDate, const std
 /// \param[out] importAvg rednia importu.
 /// \param[out] consumptionAvg rednia poboru.
 /// \param[out] productionAvg rednia produkcji.
-/// \details Funkcja ta przetwarza dane w okrelonym przedziale czasowym, obliczajc rednie wartoci dla
-/// autokonsumpcji, eksportu, importu, poboru i produkcji.
+/// \details Funkcja ta oblicza rednie wartoci dla autokonsumpcji, eksportu, importu, poboru i produkcji
+/// z indeksu sum prefiksowych i liczby wierszy w przedziale, bez przegldania samych wierszy.
 void TreeData::calculateAveragesBetweenDates(const std::string& startDate, const std::string& endDate,
     float& selfConsumptionAvg, float& exportAvg, float& importAvg,
     float& consumptionAvg, float& productionAvg) const {
-    // Inicjalizacja zmiennych sumujcych oraz liczby danych
-    float selfConsumptionSum = 0.0f, exportSum = 0.0f, importSum = 0.0f, consumptionSum = 0.0f, productionSum = 0.0f;
-    int count = 0;
-
-    // Pobranie danych w podanym przedziale czasowym
-    std::vector<RowData> data = getDataBetweenDates(startDate, endDate);
-    for (const auto& rowData : data) {
-        selfConsumptionSum += rowData.getSelfConsumption();  ///< Sumowanie autokonsumpcji
-        exportSum += rowData.getExport();  ///< Sumowanie eksportu
-        importSum += rowData.getImport();  ///< Sumowanie importu
-        consumptionSum += rowData.getConsumption();  ///< Sumowanie poboru
-        productionSum += rowData.getProduction();  ///< Sumowanie produkcji
-        count++;  ///< Zwikszanie liczby danych
-    }
+    size_t first, last;
+    findRange(startDate, endDate, first, last);  ///< Wyszukanie binarne zakresu wierszy
+    size_t count = last - first;  ///< Liczba wierszy w przedziale
 
     // Obliczanie rednich, jeli dane istniej
     if (count > 0) {
-        selfConsumptionAvg = selfConsumptionSum / count;  ///< Obliczanie redniej autokonsumpcji
-        exportAvg = exportSum / count;  ///< Obliczanie redniej eksportu
-        importAvg = importSum / count;  ///< Obliczanie redniej importu
-        consumptionAvg = consumptionSum / count;  ///< Obliczanie redniej poboru
-        productionAvg = productionSum / count;  ///< Obliczanie redniej produkcji
+        selfConsumptionAvg = static_cast<float>(prefixSums.sum(Channel::SelfConsumption, first, last) / count);  ///< Obliczanie redniej autokonsumpcji
+        exportAvg = static_cast<float>(prefixSums.sum(Channel::Export, first, last) / count);  ///< Obliczanie redniej eksportu
+        importAvg = static_cast<float>(prefixSums.sum(Channel::Import, first, last) / count);  ///< Obliczanie redniej importu
+        consumptionAvg = static_cast<float>(prefixSums.sum(Channel::Consumption, first, last) / count);  ///< Obliczanie redniej poboru
+        productionAvg = static_cast<float>(prefixSums.sum(Channel::Production, first, last) / count);  ///< Obliczanie redniej produkcji
     }
 }
+
+/// \brief Porwnuje sumy kanaw w dwch przedziaach czasowych.
+/// \param startDate1 Data pocztkowa pierwszego przedziau.
+/// \param endDate1 Data kocowa pierwszego przedziau.
+/// \param startDate2 Data pocztkowa drugiego przedziau.
+/// \param endDate2 Data kocowa drugiego przedziau.
+/// \return Sumy obu przedziaw oraz rnice bezwzgldne i procentowe dla kadego kanau.
+/// \details Granice obu przedziaw wyszukiwane s binarnie, a sumy odczytywane z indeksu sum prefiksowych -
+/// aden wiersz nie jest kopiowany ani przegldany.
+TreeData::RangeComparison TreeData::compareRanges(const std::string& startDate1, const std::string& endDate1,
+    const std::string& startDate2, const std::string& endDate2) const {
+    size_t first1, last1, first2, last2;
+    findRange(startDate1, endDate1, first1, last1);  ///< Zakres wierszy pierwszego przedziau
+    findRange(startDate2, endDate2, first2, last2);  ///< Zakres wierszy drugiego przedziau
+
+    RangeComparison result;
+    result.firstCount = last1 - first1;
+    result.secondCount = last2 - first2;
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        result.firstSum[channel] = prefixSums.sum(static_cast<Channel>(channel), first1, last1);
+        result.secondSum[channel] = prefixSums.sum(static_cast<Channel>(channel), first2, last2);
+        result.absoluteDelta[channel] = result.secondSum[channel] - result.firstSum[channel];
+        result.percentDelta[channel] = result.firstSum[channel] != 0.0
+            ? result.absoluteDelta[channel] / result.firstSum[channel] * 100.0
+            : std::numeric_limits<double>::quiet_NaN();  ///< Brak odniesienia dla zerowej sumy
+    }
+    return result;
+}
+
+/// \brief Porwnuje dane midzy dwoma zakresami czasowymi.
+/// \param startDate1 Data pocztkowa pierwszego zakresu.
+/// \param endDate1 Data kocowa pierwszego zakresu.
+/// \param startDate2 Data pocztkowa drugiego zakresu.
+/// \param endDate2 Data kocowa drugiego zakresu.
+/// \param[out] selfConsumptionDiff Rnica autokonsumpcji (drugi zakres minus pierwszy).
+/// \param[out] exportDiff Rnica eksportu.
+/// \param[out] importDiff Rnica importu.
+/// \param[out] consumptionDiff Rnica poboru.
+/// \param[out] productionDiff Rnica produkcji.
+void TreeData::compareDataBetweenDates(const std::string& startDate1, const std::string& endDate1,
+    const std::string& startDate2, const std::string& endDate2,
+    float& selfConsumptionDiff, float& exportDiff, float& importDiff,
+    float& consumptionDiff, float& productionDiff) const {
+    RangeComparison comparison = compareRanges(startDate1, endDate1, startDate2, endDate2);
+    selfConsumptionDiff = static_cast<float>(comparison.absoluteDelta[static_cast<int>(Channel::SelfConsumption)]);  ///< Rnica autokonsumpcji
+    exportDiff = static_cast<float>(comparison.absoluteDelta[static_cast<int>(Channel::Export)]);  ///< Rnica eksportu
+    importDiff = static_cast<float>(comparison.absoluteDelta[static_cast<int>(Channel::Import)]);  ///< Rnica importu
+    consumptionDiff = static_cast<float>(comparison.absoluteDelta[static_cast<int>(Channel::Consumption)]);  ///< Rnica poboru
+    productionDiff = static_cast<float>(comparison.absoluteDelta[static_cast<int>(Channel::Production)]);  ///< Rnica produkcji
+}
+
+/// \brief Oblicza statystyki zbiorcze w okrelonym przedziale czasowym.
+/// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+/// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+/// \return Liczba wierszy, sumy, minima i maksima wszystkich kanaw w przedziale.
+/// \details Funkcja schodzi po drzewie tylko tam, gdzie wze jest czciowo objty przedziaem. Lata, miesice,
+/// dni i kwartay lece w caoci wewntrz przedziau s pobierane z ich statystyk zbiorczych, a pojedyncze
+/// wiersze s przegldane wycznie na dwch brzegach przedziau.
+Aggregate TreeData::calculateStatsBetweenDates(const std::string& startDate, const std::string& endDate) const {
+    Aggregate result;  ///< Wynikowa statystyka
+    aggregateRange(parseTimestamp(startDate), static_cast<int64_t>(parseTimestamp(endDate)) + 1, result);
+    return result;
+}
+
+/// \brief Zwraca pocztek kubeka zawierajcego podany znacznik czasu.
+/// \param timestamp Znacznik czasu (minuty od 01.01.1970).
+/// \param granularity Szeroko kubeka.
+static int32_t bucketStartOf(int32_t timestamp, TreeData::Granularity granularity) {
+    static const int32_t WEEK_ORIGIN = -3 * 1440;  ///< Poniedziaek 29.12.1969 - pocztek tygodnia zawierajcego 01.01.1970
+    int32_t width = 0, origin = 0;
+    switch (granularity) {
+    case TreeData::Granularity::Minutes15: width = 15; break;
+    case TreeData::Granularity::Hour: width = 60; break;
+    case TreeData::Granularity::SixHours: width = 360; break;
+    case TreeData::Granularity::Day: width = 1440; break;
+    case TreeData::Granularity::Week: width = 7 * 1440; origin = WEEK_ORIGIN; break;
+    case TreeData::Granularity::Month: {
+        int year, month, day, hour, minute;
+        splitTimestamp(timestamp, year, month, day, hour, minute);
+        return makeTimestamp(year, month, 1, 0, 0);
+    }
+    }
+    int32_t offset = (timestamp - origin) % width;
+    return timestamp - (offset < 0 ? offset + width : offset);  ///< Zaokrglenie w d take dla dat sprzed 1970
+}
+
+/// \brief Zwraca pocztek kubeka nastpujcego po kubeku zaczynajcym si w podanej chwili.
+/// \param start Pocztek kubeka (minuty od 01.01.1970).
+/// \param granularity Szeroko kubeka.
+static int32_t bucketEndOf(int32_t start, TreeData::Granularity granularity) {
+    switch (granularity) {
+    case TreeData::Granularity::Minutes15: return start + 15;
+    case TreeData::Granularity::Hour: return start + 60;
+    case TreeData::Granularity::SixHours: return start + 360;
+    case TreeData::Granularity::Day: return start + 1440;
+    case TreeData::Granularity::Week: return start + 7 * 1440;
+    case TreeData::Granularity::Month: break;
+    }
+    int year, month, day, hour, minute;
+    splitTimestamp(start, year, month, day, hour, minute);
+    return month == 12 ? makeTimestamp(year + 1, 1, 1, 0, 0) : makeTimestamp(year, month + 1, 1, 0, 0);
+}
+
+/// \brief Zwraca szereg statystyk w kubekach o podanej szerokoci.
+/// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+/// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm (wcznie).
+/// \param granularity Szeroko kubeka.
+/// \return Kubeki w kolejnoci chronologicznej, take puste.
+/// \details Kubeki 6-godzinne i szersze pokrywaj si z wzami kalendarza (tydzie to 7 dni), wic ich
+/// statystyki s skadane z gotowych statystyk wzw, a wiersze przegldane s co najwyej w kubekach brzegowych.
+/// Kubeki 15-minutowe i godzinne s drobniejsze ni najmniejszy wze - dla nich kolumny magazynu przegldane s
+/// raz, kubeek po kubeku, funkcjami wektorowymi.
+std::vector<TreeData::Bucket> TreeData::resample(const std::string& startDate, const std::string& endDate,
+    Granularity granularity) const {
+    std::vector<Bucket> result;  ///< Wynikowy szereg kubekw
+    int64_t from = parseTimestamp(startDate);  ///< Pocztek przedziau (wcznie)
+    int64_t to = static_cast<int64_t>(parseTimestamp(endDate)) + 1;  ///< Koniec przedziau (wycznie)
+    if (store.empty()) {
+        return result;
+    }
+    // Przycicie do zakresu danych - poza nim wszystkie kubeki byyby puste
+    from = std::max<int64_t>(from, store.timestampAt(0));
+    to = std::min<int64_t>(to, static_cast<int64_t>(store.timestampAt(store.size() - 1)) + 1);
+    if (to <= from) {
+        return result;
+    }
+
+    int32_t firstStart = bucketStartOf(static_cast<int32_t>(from), granularity);
+    int32_t width = bucketEndOf(firstStart, granularity) - firstStart;  ///< Szeroko (pierwszego) kubeka
+    size_t bucketCount = static_cast<size_t>((to - firstStart) / width + 2);  ///< Grne oszacowanie liczby kubekw
+    if (bucketCount > MAX_RESAMPLE_BUCKETS) {
+        throw std::invalid_argument("Zbyt wiele kubekw w przedziale (" + std::to_string(bucketCount)
+            + "), wybierz krtszy przedzia lub szersze kubeki");
+    }
+    result.reserve(bucketCount);
+
+    bool fromRows = granularity == Granularity::Minutes15 || granularity == Granularity::Hour;
+    size_t first = fromRows ? store.lowerBound(static_cast<int32_t>(from)) : 0;  ///< Pozycja pierwszego wiersza biecego kubeka
+    for (int32_t start = firstStart; start < to; start = result.back().end) {
+        Bucket bucket;
+        bucket.start = start;
+        bucket.end = bucketEndOf(start, granularity);
+        int32_t clippedFrom = static_cast<int32_t>(std::max<int64_t>(from, bucket.start));
+        int32_t clippedTo = static_cast<int32_t>(std::min<int64_t>(to, bucket.end));
+        if (fromRows) {
+            size_t last = first;  ///< Kolumna znacznikw czasu jest posortowana - kubeki zajmuj kolejne wiersze
+            while (last < store.size() && store.timestampAt(last) < clippedTo) {
+                ++last;
+            }
+            AggregateKernels::aggregate(store, first, last, bucket.stats);
+            first = last;
+        }
+        else {
+            aggregateRange(clippedFrom, clippedTo, bucket.stats);
+        }
+        result.push_back(bucket);
+    }
+    return result;
+}
+
+/// \brief Dodaje do statystyki wiersze z przedziau [from, to), korzystajc ze statystyk wzw kalendarza.
+/// \param from Pocztek przedziau (wcznie).
+/// \param to Koniec przedziau (wycznie); 64-bitowy, aby mieci koniec po ostatniej minucie zakresu int32.
+/// \param[in,out] result Statystyka, do ktrej dodawane s wiersze.
+void TreeData::aggregateRange(int64_t from, int64_t to, Aggregate& result) const {
+    if (to <= from) {
+        return;
+    }
+
+    int fromYear, fromMonth, fromDay, fromHour, fromMinute;
+    splitTimestamp(static_cast<int32_t>(from), fromYear, fromMonth, fromDay, fromHour, fromMinute);
+
+    for (auto yearIt = years.lower_bound(fromYear); yearIt != years.end(); ++yearIt) {
+        const YearNode& yearNode = yearIt->second;  ///< Pobieranie wza roku
+        if (yearNode.start >= to) break;
+        if (yearNode.start >= from && yearNode.end <= to) {
+            result.merge(yearNode.stats);  ///< Cay rok w przedziale
+            continue;
+        }
+
+        for (const MonthNode& monthNode : yearNode.months) {
+            if (!yearNode.monthOccupied.test(monthNode.month - 1)) continue;
+            int32_t monthStart = yearNode.start + monthNode.firstDay * 1440;
+            int32_t monthEnd = monthStart + monthNode.dayCount * 1440;
+            if (monthEnd <= from) continue;
+            if (monthStart >= to) break;
+            if (monthStart >= from && monthEnd <= to) {
+                result.merge(monthNode.stats);  ///< Cay miesic w przedziale
+                continue;
+            }
+
+            // Pierwszy dzie przecinajcy przedzia wynika wprost z jego pocztku
+            int firstDay = std::max(monthNode.firstDay,
+                static_cast<int>((std::max<int64_t>(from, monthStart) - yearNode.start) / 1440));
+            for (int dayIndex = firstDay; dayIndex < monthNode.firstDay + monthNode.dayCount; ++dayIndex) {
+                if (!yearNode.dayOccupied.test(dayIndex)) continue;
+                int32_t dayStart = yearNode.start + dayIndex * 1440;
+                int32_t dayEnd = dayStart + 1440;
+                if (dayStart >= to) break;
+                if (dayStart >= from && dayEnd <= to) {
+                    result.merge(yearNode.days[dayIndex].stats);  ///< Cay dzie w przedziale
+                    continue;
+                }
+
+                for (int quarter = 0; quarter < YearNode::QUARTERS_PER_DAY; ++quarter) {
+                    int slot = dayIndex * YearNode::QUARTERS_PER_DAY + quarter;
+                    if (!yearNode.quarterOccupied.test(slot)) continue;
+                    const QuarterNode& quarterNode = yearNode.quarters[slot];  ///< Pobieranie wza kwartau
+                    int32_t quarterStart = dayStart + quarter * 360;
+                    int32_t quarterEnd = quarterStart + 360;
+                    if (quarterEnd <= from) continue;
+                    if (quarterStart >= to) break;
+                    if (quarterStart >= from && quarterEnd <= to) {
+                        result.merge(quarterNode.stats);  ///< Cay kwarta w przedziale
+                    }
+                    else {
+                        aggregateRows(static_cast<int32_t>(std::max<int64_t>(from, quarterStart)),
+                            static_cast<int32_t>(std::min<int64_t>(to, quarterEnd)), result);  ///< Brzeg przedziau
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// \brief Wyszukuje rekordy w okrelonym zakresie czasowym z uwzgldnieniem tolerancji.
+/// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+/// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+/// \param value Warto wyszukiwana.
+/// \param tolerance Tolerancja dla wartoci wyszukiwania.
+/// \return Wiersze, w ktrych warto dowolnego kanau mieci si w [value - tolerance, value + tolerance].
+std::vector<RowData> TreeData::searchRecordsWithTolerance(const std::string& startDate, const std::string& endDate,
+    float value, float tolerance) const {
+    std::vector<RowData> result;  ///< Wektor do przechowywania wynikw
+    searchValues(startDate, endDate, value, tolerance, (1u << CHANNEL_COUNT) - 1,
+        [&result](const RangeView::Row& row) { result.push_back(row.toRowData()); });
+    return result;
+}
+
+/// \brief Wyszukuje rekordy, w ktrych wskazany kana ma warto blisk podanej.
+/// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+/// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+/// \param value Warto wyszukiwana.
+/// \param tolerance Tolerancja dla wartoci wyszukiwania.
+/// \param channel Przeszukiwany kana pomiarowy.
+/// \return Wiersze, w ktrych warto kanau mieci si w [value - tolerance, value + tolerance].
+std::vector<RowData> TreeData::searchRecordsWithTolerance(const std::string& startDate, const std::string& endDate,
+    float value, float tolerance, Channel channel) const {
+    std::vector<RowData> result;  ///< Wektor do przechowywania wynikw
+    searchValues(startDate, endDate, value, tolerance, 1u << static_cast<int>(channel),
+        [&result](const RangeView::Row& row) { result.push_back(row.toRowData()); });
+    return result;
+}
+
+/// \brief Wywouje funkcj dla kadego rekordu, w ktrym warto dowolnego kanau jest bliska podanej.
+/// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+/// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+/// \param value Warto wyszukiwana.
+/// \param tolerance Tolerancja dla wartoci wyszukiwania.
+/// \param visitor Funkcja wywoywana dla pasujcych wierszy.
+void TreeData::forEachRecordWithTolerance(const std::string& startDate, const std::string& endDate,
+    float value, float tolerance, const RangeView::Visitor& visitor) const {
+    searchValues(startDate, endDate, value, tolerance, (1u << CHANNEL_COUNT) - 1, visitor);
+}
+
+/// \brief Wywouje funkcj dla kadego rekordu, w ktrym wskazany kana ma warto blisk podanej.
+/// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+/// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+/// \param value Warto wyszukiwana.
+/// \param tolerance Tolerancja dla wartoci wyszukiwania.
+/// \param channel Przeszukiwany kana pomiarowy.
+/// \param visitor Funkcja wywoywana dla pasujcych wierszy.
+void TreeData::forEachRecordWithTolerance(const std::string& startDate, const std::string& endDate,
+    float value, float tolerance, Channel channel, const RangeView::Visitor& visitor) const {
+    searchValues(startDate, endDate, value, tolerance, 1u << static_cast<int>(channel), visitor);
+}
+
+/// \brief Wyszukuje wiersze, w ktrych ktrykolwiek z kanaw maski ma warto z przedziau [low, high].
+/// \details Przegld drzewa przebiega jak w calculateStatsBetweenDates, ale wze jest pomijany take wtedy,
+/// gdy jego minimum i maksimum wykluczaj trafienie. Pojedyncze wiersze s sprawdzane tylko w kwartaach,
+/// ktrych zakres wartoci przecina szukany przedzia.
+void TreeData::searchValues(const std::string& startDate, const std::string& endDate,
+    float value, float tolerance, unsigned channelMask, const RangeView::Visitor& visitor) const {
+    if (!(tolerance >= 0.0f)) {
+        throw std::invalid_argument("Tolerancja nie moe by ujemna");
+    }
+    int64_t from = parseTimestamp(startDate);  ///< Pocztek przedziau (wcznie)
+    int64_t to = static_cast<int64_t>(parseTimestamp(endDate)) + 1;  ///< Koniec przedziau (wycznie)
+    const float low = value - tolerance, high = value + tolerance;  ///< Szukany przedzia wartoci
+    if (to <= from) {
+        return;
+    }
+
+    // Mapa stref: wze moe zawiera trafienie tylko, jeli [min, max] ktrego kanau przecina [low, high]
+    auto mayContain = [&](const Aggregate& stats) {
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            if ((channelMask & (1u << channel)) && stats.min[channel] <= high && stats.max[channel] >= low) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    int fromYear, fromMonth, fromDay, fromHour, fromMinute;
+    splitTimestamp(static_cast<int32_t>(from), fromYear, fromMonth, fromDay, fromHour, fromMinute);
+
+    for (auto yearIt = years.lower_bound(fromYear); yearIt != years.end(); ++yearIt) {
+        const YearNode& yearNode = yearIt->second;  ///< Pobieranie wza roku
+        if (yearNode.start >= to) break;
+        if (!mayContain(yearNode.stats)) continue;
+
+        for (const MonthNode& monthNode : yearNode.months) {
+            if (!yearNode.monthOccupied.test(monthNode.month - 1)) continue;
+            int32_t monthStart = yearNode.start + monthNode.firstDay * 1440;
+            int32_t monthEnd = monthStart + monthNode.dayCount * 1440;
+            if (monthEnd <= from) continue;
+            if (monthStart >= to) break;
+            if (!mayContain(monthNode.stats)) continue;
+
+            int firstDay = std::max(monthNode.firstDay,
+                static_cast<int>((std::max<int64_t>(from, monthStart) - yearNode.start) / 1440));
+            for (int dayIndex = firstDay; dayIndex < monthNode.firstDay + monthNode.dayCount; ++dayIndex) {
+                if (!yearNode.dayOccupied.test(dayIndex)) continue;
+                int32_t dayStart = yearNode.start + dayIndex * 1440;
+                if (dayStart >= to) break;
+                if (!mayContain(yearNode.days[dayIndex].stats)) continue;
+
+                for (int quarter = 0; quarter < YearNode::QUARTERS_PER_DAY; ++quarter) {
+                    int slot = dayIndex * YearNode::QUARTERS_PER_DAY + quarter;
+                    if (!yearNode.quarterOccupied.test(slot)) continue;
+                    const QuarterNode& quarterNode = yearNode.quarters[slot];  ///< Pobieranie wza kwartau
+                    int32_t quarterStart = dayStart + quarter * 360;
+                    int32_t quarterEnd = quarterStart + 360;
+                    if (quarterEnd <= from) continue;
+                    if (quarterStart >= to) break;
+                    if (!mayContain(quarterNode.stats)) continue;
+
+                    // Sprawdzanie pojedynczych wierszy kwartau
+                    size_t last = store.lowerBound(static_cast<int32_t>(std::min<int64_t>(to, quarterEnd)));
+                    for (size_t i = store.lowerBound(static_cast<int32_t>(std::max<int64_t>(from, quarterStart))); i < last; ++i) {
+                        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                            float rowValue = store.valueAt(static_cast<Channel>(channel), i);
+                            if ((channelMask & (1u << channel)) && rowValue >= low && rowValue <= high) {
+                                visitor(RangeView::Row(&store, i));  ///< Przekazanie wiersza bez kopiowania
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// \brief Dodaje do statystyki wiersze z przedziau [from, to).
+/// \param from Pocztek przedziau (wcznie).
+/// \param to Koniec przedziau (wycznie).
+/// \param[in,out] result Statystyka, do ktrej dodawane s wiersze.
+void TreeData::aggregateRows(int32_t from, int32_t to, Aggregate& result) const {
+    AggregateKernels::aggregate(store, store.lowerBound(from), store.lowerBound(to), result);  ///< Przebieg wektorowy po kolumnach
+}
+
+/// \brief Wyznacza zakres pozycji wierszy w magazynie odpowiadajcy przedziaowi dat.
+/// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+/// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm (wcznie).
+/// \param[out] first Pozycja pierwszego wiersza w przedziale.
+/// \param[out] last Pozycja za ostatnim wierszem w przedziale.
+/// \details Daty graniczne s parsowane tylko raz, a obie granice wyszukiwane binarnie w posortowanej kolumnie
+/// znacznikw czasu. Zapytanie o jeden dzie dotyka wic tylko wierszy z tego dnia.
+void TreeData::findRange(const std::string& startDate, const std::string& endDate, size_t& first, size_t& last) const {
+    int32_t start = parseTimestamp(startDate);  ///< Znacznik czasu daty pocztkowej
+    int32_t end = parseTimestamp(endDate);  ///< Znacznik czasu daty kocowej
+
+    first = store.lowerBound(start);
+    last = end < start ? first : store.upperBound(end);
+}
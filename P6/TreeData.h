@@ -4,57 +4,198 @@
 #ifndef TREEDATA_H
 #define TREEDATA_H
 
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <istream>
 #include <map>
+#include <memory_resource>
+#include <ostream>
 #include <string>
 #include <vector>
 #include "RowData.h" ///< Zaczenie pliku nagwkowego zawierajcego klas RowData.
+#include "ColumnStore.h" ///< Kolumnowy magazyn wierszy danych.
+#include "PrefixSumIndex.h" ///< Indeks sum prefiksowych dla zapyta o sumy i rednie.
+#include "Aggregate.h" ///< Statystyki zbiorcze przechowywane w wzach drzewa.
+#include "RangeView.h" ///< Widoki na zakresy wierszy, zwracane bez kopiowania danych.
 
 /// \class TreeData
 /// \brief Klasa przechowujca dane w hierarchicznej strukturze drzewa na podstawie danych z pliku CSV.
 /// Klasa ta umoliwia organizowanie danych w strukturze drzewa, gdzie dane s przechowywane wedug roku, miesica, dnia i kwartau.
 /// Dziki tej strukturze moliwa jest analiza oraz obliczenia na danych w zalenoci od zakresu czasowego.
+/// Same wiersze przechowywane s w kolumnowym magazynie ColumnStore, posortowanym wedug czasu,
+/// a wzy drzewa opisuj jedynie kalendarz, w ktrym wystpuj dane.
+/// Wzy kalendarza s przydzielane z zasobu pamici (std::pmr::memory_resource) podanego w konstruktorze,
+/// np. puli lub areny - kady rok to jedna alokacja tablicy dni i jedna tablicy kwartaw.
 class TreeData {
 public:
     /// \struct QuarterNode
-    /// \brief Reprezentuje dane z podziaem na kwartay dnia.
-    /// Struktura ta zawiera informacje o godzinie, minucie oraz dane przypisane do danego kwartau.
+    /// \brief Reprezentuje dane z podziaem na kwartay dnia (okresy 6-godzinne).
+    /// Struktura ta zawiera informacje o godzinie i minucie rozpoczcia kwartau. Wiersze kwartau znajduj si w magazynie kolumnowym.
     struct QuarterNode {
-        int quarter; ///< Numer kwartau (0-3), np. 0 - pierwsza cz godziny, 1 - druga cz godziny itd.
+        int quarter; ///< Numer kwartau (0-3), np. 0 - godziny 0:00-5:59, 1 - godziny 6:00-11:59 itd.
         int hour; ///< Godzina rozpoczcia kwartau (0-23).
         int minute; ///< Minuta rozpoczcia kwartau (0-59).
-        std::vector<RowData> data; ///< Dane przypisane do kwartau, przechowywane jako wektor obiektw RowData.
+        Aggregate stats; ///< Statystyki zbiorcze wierszy kwartau.
     };
 
     /// \struct DayNode
     /// \brief Reprezentuje dane dzienne.
-    /// Struktura ta zawiera informacje o danym dniu oraz map kwartalnych danych w tym dniu.
+    /// Kwartay dnia znajduj si w tablicy kwartaw roku, na pozycjach od dnia roku * 4.
     struct DayNode {
         int day; ///< Dzie miesica (1-31).
-        std::map<int, QuarterNode> quarters; ///< Mapa kwartalnych danych w dniu, gdzie kluczem jest numer kwartau.
+        Aggregate stats; ///< Statystyki zbiorcze wierszy dnia.
     };
 
     /// \struct MonthNode
     /// \brief Reprezentuje dane miesiczne.
-    /// Struktura ta zawiera informacje o danym miesicu oraz map dziennych danych w tym miesicu.
+    /// Dni miesica znajduj si w tablicy dni roku, na pozycjach [firstDay, firstDay + dayCount).
     struct MonthNode {
         int month; ///< Numer miesica (1-12).
-        std::map<int, DayNode> days; ///< Mapa dziennych danych w miesicu, gdzie kluczem jest numer dnia.
+        int firstDay; ///< Numer pierwszego dnia miesica w roku (liczony od 0).
+        int dayCount; ///< Liczba dni miesica.
+        Aggregate stats; ///< Statystyki zbiorcze wierszy miesica.
     };
 
     /// \struct YearNode
     /// \brief Reprezentuje dane roczne.
-    /// Struktura ta zawiera informacje o roku oraz map miesicznych danych w tym roku.
+    /// Kalendarz roku jest gsty: miesice, dni i kwartay zajmuj tablice o staym rozmiarze indeksowane odpowiednio
+    /// numerem miesica, dniem roku i kwartaem roku, a mapy bitowe zajtoci wskazuj, w ktrych okresach s dane.
+    /// Wstawienie wiersza i wyszukanie okresu to wic zwyke indeksowanie tablic.
     struct YearNode {
-        int year; ///< Rok (np. 2023).
-        std::map<int, MonthNode> months; ///< Mapa miesicznych danych w roku, gdzie kluczem jest numer miesica.
+        using allocator_type = std::pmr::polymorphic_allocator<char>; ///< Alokator tablic dni i kwartaw.
+
+        static const int DAY_SLOTS = 366; ///< Liczba pozycji w tablicy dni (rok przestpny).
+        static const int QUARTERS_PER_DAY = 4; ///< Liczba kwartaw (6-godzinnych) w dniu.
+        static const int QUARTER_SLOTS = DAY_SLOTS * QUARTERS_PER_DAY; ///< Liczba pozycji w tablicy kwartaw.
+
+        int year = 0; ///< Rok (np. 2023).
+        int32_t start = 0; ///< Pocztek roku (minuty od 01.01.1970).
+        int32_t end = 0; ///< Pocztek nastpnego roku (minuty od 01.01.1970).
+        std::array<MonthNode, 12> months; ///< Miesice roku, indeksowane numerem miesica - 1.
+        std::pmr::vector<DayNode> days; ///< Dni roku, indeksowane numerem dnia w roku.
+        std::pmr::vector<QuarterNode> quarters; ///< Kwartay roku, indeksowane numerem dnia w roku * 4 + kwarta.
+        std::bitset<12> monthOccupied; ///< Mapa bitowa miesicy, w ktrych s dane.
+        std::bitset<DAY_SLOTS> dayOccupied; ///< Mapa bitowa dni, w ktrych s dane.
+        std::bitset<QUARTER_SLOTS> quarterOccupied; ///< Mapa bitowa kwartaw, w ktrych s dane.
+        Aggregate stats; ///< Statystyki zbiorcze wierszy roku.
+
+        /// \brief Tworzy pusty wze, ktrego tablice dni i kwartaw korzystaj z podanego alokatora.
+        explicit YearNode(const allocator_type& allocator = {})
+            : months(), days(DAY_SLOTS, allocator), quarters(QUARTER_SLOTS, allocator) {}
+
+        /// \brief Kopiuje wze, przydzielajc tablice z podanego alokatora.
+        YearNode(const YearNode& other, const allocator_type& allocator = {})
+            : year(other.year), start(other.start), end(other.end), months(other.months),
+            days(other.days, allocator), quarters(other.quarters, allocator), monthOccupied(other.monthOccupied),
+            dayOccupied(other.dayOccupied), quarterOccupied(other.quarterOccupied), stats(other.stats) {}
+    };
+
+    /// \enum Granularity
+    /// \brief Szeroko przedziau (kubeka) szeregu czasowego zwracanego przez resample().
+    /// Kubeki s wyrwnane do kalendarza: godziny do penych godzin, dni do pnocy, tygodnie do poniedziaku,
+    /// a miesice do pierwszego dnia miesica.
+    enum class Granularity {
+        Minutes15, ///< 15 minut.
+        Hour, ///< 1 godzina.
+        SixHours, ///< 6 godzin (kwarta dnia).
+        Day, ///< 1 dzie.
+        Week, ///< 1 tydzie (od poniedziaku).
+        Month ///< 1 miesic kalendarzowy.
+    };
+
+    /// \struct Bucket
+    /// \brief Statystyki jednego kubeka szeregu czasowego.
+    struct Bucket {
+        int32_t start; ///< Pocztek kubeka (minuty od 01.01.1970).
+        int32_t end; ///< Koniec kubeka, wycznie (minuty od 01.01.1970).
+        Aggregate stats; ///< Liczba wierszy, sumy, minima i maksima kanaw (rednia: stats.average()).
     };
 
+    /// \struct RangeComparison
+    /// \brief Wynik porwnania dwch przedziaw czasowych dla wszystkich kanaw.
+    struct RangeComparison {
+        size_t firstCount; ///< Liczba wierszy w pierwszym przedziale.
+        size_t secondCount; ///< Liczba wierszy w drugim przedziale.
+        double firstSum[CHANNEL_COUNT]; ///< Sumy kanaw w pierwszym przedziale.
+        double secondSum[CHANNEL_COUNT]; ///< Sumy kanaw w drugim przedziale.
+        double absoluteDelta[CHANNEL_COUNT]; ///< Rnica sum: drugi przedzia minus pierwszy.
+        double percentDelta[CHANNEL_COUNT]; ///< Rnica wzgldem pierwszego przedziau w procentach (NaN, gdy suma pierwszego wynosi 0).
+    };
+
+    /// \brief Konstruktor drzewa.
+    /// \param resource Zasb pamici, z ktrego przydzielane s wzy kalendarza; musi istnie duej ni drzewo.
+    /// \details Z aren (std::pmr::monotonic_buffer_resource) lub pul (std::pmr::unsynchronized_pool_resource)
+    /// wzy powstaj w kilku duych blokach, a zwolnienie drzewa nie wywouje free dla kadego wza.
+    /// Kopia drzewa korzysta z domylnego zasobu pamici.
+    explicit TreeData(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /// \brief Zwraca zasb pamici, z ktrego przydzielane s wzy kalendarza.
+    std::pmr::memory_resource* resource() const { return years.get_allocator().resource(); }
+
     /// \brief Dodaje dane do struktury drzewa.
     /// \param rowData Obiekt RowData reprezentujcy wiersz danych do dodania.
     /// \details Funkcja ta dodaje dane do odpowiedniej pozycji w hierarchii drzewa na podstawie daty i czasu.
     /// Tworzy lub aktualizuje odpowiednie wzy drzewa, wstawiajc dane w odpowiednim roku, miesicu, dniu i kwartale.
     void addData(const RowData& rowData);
 
+    /// \brief Dodaje wiersz, jeli drzewo nie zawiera jeszcze wiersza o tym samym znaczniku czasu.
+    /// \param rowData Wiersz danych do dodania.
+    /// \return true, jeli wiersz zosta dodany, false jeli by duplikatem.
+    /// \details Wiersz nowszy od wszystkich dotychczasowych jest dopisywany bez wyszukiwania, a statystyki wzw
+    /// i sumy prefiksowe aktualizowane przyrostowo - ponowne wczytanie tych samych danych nie powiela wierszy.
+    bool addDataUnique(const RowData& rowData);
+
+    /// \brief Dodaje paczk wierszy.
+    /// \param rows Wskanik na pierwszy wiersz paczki.
+    /// \param count Liczba wierszy.
+    /// \param skipDuplicates true, jeli pomijane maj by wiersze o znacznikach czasu obecnych ju w drzewie
+    /// lub powtrzonych w paczce (jak w addDataUnique).
+    /// \return Liczba dodanych wierszy.
+    /// \details Paczka uporzdkowana chronologicznie i nowsza od danych drzewa (typowy plik eksportu) jest dopisywana
+    /// wprost na koniec kolumn. Pozostae paczki s sortowane i scalane z magazynem jednym przebiegiem od koca,
+    /// zamiast wstawiania kadego wiersza w rodek kolumn. Wzy kalendarza s aktualizowane raz na kwarta
+    /// (statystyk wszystkich wierszy kwartau), a sumy prefiksowe przeliczane od pierwszej zmienionej pozycji.
+    size_t addBatch(const RowData* rows, size_t count, bool skipDuplicates = false);
+
+    /// \brief Dodaje paczk wierszy z wektora.
+    /// \param rows Wiersze paczki.
+    /// \param skipDuplicates true, jeli pomijane maj by powtrzone znaczniki czasu.
+    /// \return Liczba dodanych wierszy.
+    size_t addBatch(const std::vector<RowData>& rows, bool skipDuplicates = false) {
+        return addBatch(rows.data(), rows.size(), skipDuplicates);
+    }
+
+    /// \brief Zwraca liczb wierszy przechowywanych w drzewie.
+    size_t size() const;
+
+    /// \brief Zapisuje dane drzewa do strumienia w formacie migawki (Snapshot).
+    /// \param out Strumie wyjciowy otwarty w trybie binarnym.
+    /// \throws std::runtime_error Gdy zapis si nie powiedzie.
+    void saveSnapshot(std::ostream& out) const;
+
+    /// \brief Zastpuje dane drzewa zawartoci migawki (Snapshot).
+    /// \param in Strumie wejciowy otwarty w trybie binarnym.
+    /// \throws std::runtime_error Gdy migawka jest uszkodzona lub ma nieobsugiwany format; drzewo jest wtedy puste.
+    void loadSnapshot(std::istream& in);
+
+    /// \brief Zapisuje dane drzewa do pliku indeksu (IndexFile), ktry mona pniej odwzorowa w pamici.
+    /// \param path cieka do pliku indeksu.
+    /// \throws std::runtime_error Gdy zapis si nie powiedzie.
+    /// \details Drzewo otwarte przez openIndex najpierw kopiuje kolumny i sumy do pamici programu i zwalnia
+    /// swoje odwzorowanie pliku - w systemie Windows pliku odwzorowanego w pamici nie mona podmieni, wic
+    /// bez tego zapis pod ciek otwartego indeksu zawsze by si nie uda.
+    void saveIndex(const std::string& path);
+
+    /// \brief Zastpuje dane drzewa plikiem indeksu odwzorowanym w pamici.
+    /// \param path cieka do pliku indeksu.
+    /// \return true, jeli indeks zosta otwarty; false, jeli plik nie istnieje (drzewo pozostaje bez zmian).
+    /// \throws std::runtime_error Gdy plik jest uszkodzony lub ma nieobsugiwany format.
+    /// \details Kolumny i sumy prefiksowe s czytane bezporednio z odwzorowanego pliku, bez kopiowania.
+    /// Wzy kalendarza powstaj z zapisanych statystyk kwartaw, dni i miesicy, bez przegldania wierszy.
+    /// Pierwsze wywoanie addData kopiuje kolumny do pamici programu.
+    bool openIndex(const std::string& path);
+
     /// \brief Wywietla ca struktur drzewa.
     /// \details Funkcja ta wypisuje ca struktur danych, poczwszy od lat, przez miesice, dni, a po kwartay.
     /// Pozwala na wizualizacj danych w drzewiastej strukturze hierarchicznej.
@@ -65,8 +206,18 @@ public:
     /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
     /// \return Wektor obiektw RowData, ktre mieszcz si w podanym przedziale czasowym.
     /// \details Funkcja ta filtruje dane i zwraca wszystkie rekordy, ktre mieszcz si w okrelonym zakresie dat.
+    /// Do przegldania wierszy bez kopiowania suy viewBetweenDates().
     std::vector<RowData> getDataBetweenDates(const std::string& startDate, const std::string& endDate) const;
 
+    /// \brief Zwraca widok na wiersze w okrelonym przedziale czasowym, bez kopiowania danych.
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+    /// \return Widok, po ktrym mona iterowa, nakada filtry (RangeView::filter) lub liczy statystyki.
+    /// \throws std::invalid_argument Gdy format daty jest nieprawidowy.
+    /// \details Widok wskazuje bezporednio na kolumny magazynu i traci wano po kolejnym addData,
+    /// loadSnapshot lub openIndex.
+    RangeView viewBetweenDates(const std::string& startDate, const std::string& endDate) const;
+
     /// \brief Oblicza sumy danych w okrelonym przedziale czasowym.
     /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
     /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
@@ -95,6 +246,30 @@ public:
         float& selfConsumptionAvg, float& exportAvg, float& importAvg,
         float& consumptionAvg, float& productionAvg) const;
 
+    /// \brief Oblicza statystyki zbiorcze w okrelonym przedziale czasowym.
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+    /// \return Liczba wierszy, sumy, minima i maksima wszystkich kanaw w przedziale.
+    /// \details Wzy drzewa objte w caoci przedziaem dostarczaj gotowych statystyk, a pojedyncze wiersze
+    /// przegldane s tylko na brzegach przedziau.
+    Aggregate calculateStatsBetweenDates(const std::string& startDate, const std::string& endDate) const;
+
+    /// \brief Zwraca szereg statystyk w kubekach o podanej szerokoci.
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm (wcznie).
+    /// \param granularity Szeroko kubeka.
+    /// \return Kubeki w kolejnoci chronologicznej, take puste (stats.count == 0). Przedzia jest najpierw
+    /// przycinany do zakresu przechowywanych danych, wic szereg zaczyna si kubekiem zawierajcym pierwszy
+    /// wiersz przedziau, a koczy kubekiem zawierajcym ostatni. Kubeki brzegowe obejmuj tylko cz
+    /// przedziau [startDate, endDate].
+    /// \throws std::invalid_argument Gdy format daty jest nieprawidowy lub szereg miaby wicej ni
+    /// MAX_RESAMPLE_BUCKETS kubekw.
+    /// \details Kubeki od 6 godzin wzwy s skadane ze statystyk wzw kalendarza, bez przegldania wierszy.
+    /// Drobniejsze kubeki powstaj w jednym przebiegu po kolumnach magazynu w przedziale.
+    std::vector<Bucket> resample(const std::string& startDate, const std::string& endDate, Granularity granularity) const;
+
+    static const size_t MAX_RESAMPLE_BUCKETS = 1 << 20; ///< Najwiksza liczba kubekw zwracana przez resample().
+
     /// \brief Porwnuje dane midzy dwoma zakresami czasowymi.
     /// \param startDate1 Data pocztkowa pierwszego zakresu.
     /// \param endDate1 Data kocowa pierwszego zakresu.
@@ -106,12 +281,24 @@ public:
     /// \param[out] consumptionDiff Rnica poboru midzy dwoma zakresami czasowymi.
     /// \param[out] productionDiff Rnica produkcji midzy dwoma zakresami czasowymi.
     /// \details Funkcja ta porwnuje dane w dwch okrelonych zakresach czasowych i oblicza rnice w wartociach dla 
-    /// autokonsumpcji, eksportu, importu, poboru i produkcji.
+    /// autokonsumpcji, eksportu, importu, poboru i produkcji (suma drugiego zakresu minus suma pierwszego).
+    /// Wyniki pochodz z compareRanges().
     void compareDataBetweenDates(const std::string& startDate1, const std::string& endDate1,
         const std::string& startDate2, const std::string& endDate2,
         float& selfConsumptionDiff, float& exportDiff, float& importDiff,
         float& consumptionDiff, float& productionDiff) const;
 
+    /// \brief Porwnuje sumy kanaw w dwch przedziaach czasowych.
+    /// \param startDate1 Data pocztkowa pierwszego przedziau.
+    /// \param endDate1 Data kocowa pierwszego przedziau.
+    /// \param startDate2 Data pocztkowa drugiego przedziau.
+    /// \param endDate2 Data kocowa drugiego przedziau.
+    /// \return Sumy obu przedziaw oraz rnice bezwzgldne i procentowe dla kadego kanau.
+    /// \details Kady przedzia to dwa wyszukiwania binarne i odczyt z indeksu sum prefiksowych, wic koszt
+    /// porwnania wynosi O(log n) niezalenie od dugoci przedziaw i nie wymaga kopiowania wierszy.
+    RangeComparison compareRanges(const std::string& startDate1, const std::string& endDate1,
+        const std::string& startDate2, const std::string& endDate2) const;
+
     /// \brief Wyszukuje rekordy w okrelonym zakresie czasowym z uwzgldnieniem tolerancji.
     /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
     /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
@@ -119,12 +306,111 @@ public:
     /// \param tolerance Tolerancja dla wartoci wyszukiwania.
     /// \return Wektor obiektw RowData, ktre speniaj kryteria wyszukiwania.
     /// \details Funkcja ta umoliwia wyszukiwanie danych w okrelonym przedziale czasowym, uwzgldniajc tolerancj 
-    /// dla wyszukiwanej wartoci.
+    /// dla wyszukiwanej wartoci. Wiersz spenia kryterium, jeli warto dowolnego kanau mieci si
+    /// w przedziale [value - tolerance, value + tolerance].
+    /// \throws std::invalid_argument Gdy tolerancja jest ujemna lub format daty jest nieprawidowy.
     std::vector<RowData> searchRecordsWithTolerance(const std::string& startDate, const std::string& endDate,
         float value, float tolerance) const;
 
+    /// \brief Wyszukuje rekordy, w ktrych wskazany kana ma warto blisk podanej.
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+    /// \param value Warto wyszukiwana.
+    /// \param tolerance Tolerancja dla wartoci wyszukiwania.
+    /// \param channel Przeszukiwany kana pomiarowy.
+    /// \return Wiersze w kolejnoci chronologicznej, w ktrych warto kanau mieci si w [value - tolerance, value + tolerance].
+    /// \throws std::invalid_argument Gdy tolerancja jest ujemna lub format daty jest nieprawidowy.
+    /// \details Minima i maksima przechowywane w wzach drzewa dziaaj jak mapy stref: lata, miesice, dni
+    /// i kwartay, ktrych zakres wartoci nie przecina szukanego przedziau, s pomijane w caoci, a wiersze
+    /// przegldane s tylko w pozostaych kwartaach.
+    std::vector<RowData> searchRecordsWithTolerance(const std::string& startDate, const std::string& endDate,
+        float value, float tolerance, Channel channel) const;
+
+    /// \brief Wywouje funkcj dla kadego rekordu, w ktrym warto dowolnego kanau jest bliska podanej.
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+    /// \param value Warto wyszukiwana.
+    /// \param tolerance Tolerancja dla wartoci wyszukiwania.
+    /// \param visitor Funkcja wywoywana w kolejnoci chronologicznej dla wierszy speniajcych kryterium.
+    /// \throws std::invalid_argument Gdy tolerancja jest ujemna lub format daty jest nieprawidowy.
+    /// \details Dziaa jak searchRecordsWithTolerance, ale nie kopiuje wierszy do wektora.
+    void forEachRecordWithTolerance(const std::string& startDate, const std::string& endDate,
+        float value, float tolerance, const RangeView::Visitor& visitor) const;
+
+    /// \brief Wywouje funkcj dla kadego rekordu, w ktrym wskazany kana ma warto blisk podanej.
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+    /// \param value Warto wyszukiwana.
+    /// \param tolerance Tolerancja dla wartoci wyszukiwania.
+    /// \param channel Przeszukiwany kana pomiarowy.
+    /// \param visitor Funkcja wywoywana w kolejnoci chronologicznej dla wierszy speniajcych kryterium.
+    /// \throws std::invalid_argument Gdy tolerancja jest ujemna lub format daty jest nieprawidowy.
+    void forEachRecordWithTolerance(const std::string& startDate, const std::string& endDate,
+        float value, float tolerance, Channel channel, const RangeView::Visitor& visitor) const;
+
 private:
-    std::map<int, YearNode> years; ///< Mapa lat, w ktrych znajduj si dane w strukturze drzewa.
+    /// \brief Dodaje wiersz do wzw kalendarza i aktualizuje ich statystyki zbiorcze.
+    /// \param rowData Obiekt RowData reprezentujcy wiersz danych.
+    void addToNodes(const RowData& rowData);
+
+    /// \brief Dodaje do wzw kalendarza wiersze magazynu z pozycji [first, last), uporzdkowane chronologicznie.
+    /// \param source Magazyn zawierajcy wiersze.
+    /// \param first Pozycja pierwszego wiersza.
+    /// \param last Pozycja za ostatnim wierszem.
+    /// \details Kolejne wiersze tego samego kwartau s sumowane funkcjami AggregateKernels, a wzy roku,
+    /// miesica, dnia i kwartau aktualizowane raz na kwarta; wze roku jest wyszukiwany tylko przy zmianie roku.
+    void addRangeToNodes(const ColumnStore& source, size_t first, size_t last);
+
+    /// \brief Docza statystyk wierszy jednego kwartau do wzw kalendarza.
+    /// \param node Wze roku.
+    /// \param month Miesic (1-12).
+    /// \param day Dzie miesica.
+    /// \param dayIndex Numer dnia w roku (od 0).
+    /// \param quarter Numer kwartau w dniu (0-3).
+    /// \param part Statystyka wierszy kwartau.
+    void addToQuarter(YearNode& node, int month, int day, int dayIndex, int quarter, const Aggregate& part);
+
+    /// \brief Zwraca wze roku, tworzc go (wraz z ukadem miesicy) przy pierwszym uyciu.
+    /// \param year Rok.
+    YearNode& yearNode(int year);
+
+    /// \brief Odbudowuje wzy kalendarza i indeks sum prefiksowych na podstawie magazynu.
+    void rebuildIndexes();
+
+    /// \brief Wyznacza zakres pozycji wierszy w magazynie odpowiadajcy przedziaowi dat.
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm (wcznie).
+    /// \param[out] first Pozycja pierwszego wiersza w przedziale.
+    /// \param[out] last Pozycja za ostatnim wierszem w przedziale.
+    /// \details Obie granice wyszukiwane s binarnie w kolumnie znacznikw czasu, wic koszt nie zaley
+    /// od liczby wierszy spoza przedziau.
+    void findRange(const std::string& startDate, const std::string& endDate, size_t& first, size_t& last) const;
+
+    /// \brief Wyszukuje wiersze, w ktrych ktrykolwiek z kanaw maski ma warto z przedziau [low, high].
+    /// \param startDate Data pocztkowa w formacie dd.mm.yyyy hh:mm.
+    /// \param endDate Data kocowa w formacie dd.mm.yyyy hh:mm.
+    /// \param value Warto wyszukiwana.
+    /// \param tolerance Tolerancja dla wartoci wyszukiwania.
+    /// \param channelMask Maska bitowa przeszukiwanych kanaw (bit i odpowiada kanaowi i).
+    /// \param visitor Funkcja wywoywana dla pasujcych wierszy w kolejnoci chronologicznej.
+    void searchValues(const std::string& startDate, const std::string& endDate,
+        float value, float tolerance, unsigned channelMask, const RangeView::Visitor& visitor) const;
+
+    /// \brief Dodaje do statystyki wiersze z przedziau [from, to), korzystajc ze statystyk wzw kalendarza.
+    /// \param from Pocztek przedziau (wcznie).
+    /// \param to Koniec przedziau (wycznie); 64-bitowy, aby mieci koniec po ostatniej minucie zakresu int32.
+    /// \param[in,out] result Statystyka, do ktrej dodawane s wiersze.
+    void aggregateRange(int64_t from, int64_t to, Aggregate& result) const;
+
+    /// \brief Dodaje do statystyki wiersze z przedziau [from, to).
+    /// \param from Pocztek przedziau (wcznie).
+    /// \param to Koniec przedziau (wycznie).
+    /// \param[in,out] result Statystyka, do ktrej dodawane s wiersze.
+    void aggregateRows(int32_t from, int32_t to, Aggregate& result) const;
+
+    std::pmr::map<int, YearNode> years; ///< Mapa lat, w ktrych znajduj si dane w strukturze drzewa.
+    ColumnStore store; ///< Kolumnowy magazyn wierszy, posortowany wedug czasu.
+    PrefixSumIndex prefixSums; ///< Sumy prefiksowe kanaw, aktualizowane przy kadym addData.
 };
 
 #endif // TREEDATA_H
@@ -3,16 +3,21 @@
 /// \details Program umoliwia wczytywanie danych z pliku CSV, ich analiz, przetwarzanie oraz zapisywanie w pliku binarnym.
 /// Oferuje funkcje takie jak obliczanie sum i rednich, porwnywanie danych oraz wyszukiwanie z tolerancj.
 
+#include <cmath>
 #include <iostream>
 #include <fstream>
+#include <memory_resource>
 #include <string>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
 #include "RowData.h"  ///< Zawiera definicj klasy RowData do przechowywania wierszy danych.
 #include "LogManager.h" ///< Zawiera definicj klasy LogManager do logowania komunikatw.
 #include "TreeData.h" ///< Zawiera definicj klasy TreeData do przechowywania danych w strukturze drzewa.
-#include "LineValidation.h"  ///< Zawiera funkcje do walidacji wierszy danych.
+#include "CsvParser.h"  ///< Zawiera parser wierszy CSV z walidacj danych.
+#include "CsvFollower.h"  ///< Zawiera przyrostowe wczytywanie dopisywanego pliku CSV.
+#include "MultiSiteData.h" ///< Zawiera serie wielu instalacji na wsplnej osi czasu.
 
 using namespace std;
 
@@ -20,7 +25,7 @@ using namespace std;
 /// \details Funkcja drukuje dostpne opcje programu na standardowe wyjcie.
 void displayMenu() {
     cout << "Menu:" << endl;
-    cout << "1. Load data from file" << endl;
+    cout << "1. Load new data from file" << endl;
     cout << "2. Print tree structure" << endl;
     cout << "3. Get data between dates" << endl;
     cout << "4. Calculate sums between dates" << endl;
@@ -29,23 +34,36 @@ void displayMenu() {
     cout << "7. Search records with tolerance" << endl;
     cout << "8. Save data to binary file" << endl;
     cout << "9. Load data from binary file" << endl;
-    cout << "10. Exit" << endl;
+    cout << "10. Resample data between dates" << endl;
+    cout << "11. Calculate cross-site totals between dates" << endl;
+    cout << "12. Exit" << endl;
     cout << "Enter your choice: ";
 }
 
 /// \brief Funkcja gwna programu.
 /// \details Gwna ptla programu, ktra obsuguje menu i poszczeglne funkcjonalnoci.
+/// \param argc Liczba argumentw programu.
+/// \param argv Argumenty programu; pierwszy (opcjonalny) to nazwa pliku CSV, domylnie "Chart Export.csv".
+/// Wszystkie podane pliki CSV s te wczytywane jako osobne instalacje na potrzeby zestawie zbiorczych (opcja 11).
 /// \return Zwraca 0 w przypadku pomylnego zakoczenia programu.
-int main() {
-    TreeData treeData; ///< Struktura drzewa do przechowywania danych.
-    vector<RowData> data; ///< Zmienna przechowujca dane w postaci wierszy.
-    string line; ///< Aktualnie przetwarzany wiersz danych.
-    ifstream file; ///< Strumie do odczytu pliku CSV.
+int main(int argc, char* argv[]) {
+    std::pmr::unsynchronized_pool_resource nodePool; ///< Pula pamici dla wzw kalendarza drzewa.
+    TreeData treeData(&nodePool); ///< Struktura drzewa do przechowywania danych.
+    string csvFileName = argc > 1 ? argv[1] : "Chart Export.csv"; ///< Nazwa pliku CSV (pierwszy argument programu).
+    CsvFollower csvFollower(csvFileName); ///< Przyrostowe wczytywanie pliku CSV (tylko nowe wiersze).
+    MultiSiteData sites; ///< Serie wszystkich instalacji podanych w argumentach programu.
     string startDate, endDate, startDate1, endDate1, startDate2, endDate2; ///< Daty uywane w analizie danych.
     float autokonsumpcjaSum, eksportSum, importSum, poborSum, produkcjaSum; ///< Wyniki oblicze sum.
-    float autokonsumpcjaDiff, eksportDiff, importDiff, poborDiff, produkcjaDiff; ///< Wyniki porwna.
     float searchValue, tolerance; ///< Parametry do wyszukiwania z tolerancj.
-    vector<RowData> filteredData, recordsWithTolerance; ///< Zmienna do przechowywania wynikw wyszukiwania z tolerancj.
+    int searchChannel; ///< Numer przeszukiwanego kanau (0 - wszystkie).
+    int granularityChoice; ///< Numer szerokoci kubeka szeregu czasowego.
+    const RangeView::Visitor displayRow = [](const RangeView::Row& row) {
+        row.toRowData().display();  ///< Wywietlanie wiersza.
+    }; ///< Wypisuje wiersze wynikw bez kopiowania ich do wektora.
+
+    // Logi s zapisywane w tle, paczkami - wczytywanie danych nie czeka na zapis kadego wiersza logu.
+    globalLogger.startAsync();
+    errorLogger.startAsync();
 
     while (true) {
         displayMenu(); ///< Wywietlanie menu uytkownika.
@@ -53,156 +71,224 @@ int main() {
         cin >> choice;
         cin.ignore(); ///< Ignoruj znak nowej linii pozostawiony w buforze.
 
-        switch (choice) {
-        case 1:
-            /// \brief Wczytanie danych z pliku CSV.
-            /// \details Dane s wczytywane do struktury drzewa i wektora, a niepoprawne wiersze s logowane.
-            file.open("Chart Export.csv");
-            if (!file.is_open()) {
-                cerr << "Error opening file" << endl;
-                return 1;
+        try {
+            switch (choice) {
+            case 1:
+                /// \brief Wczytanie danych z pliku CSV.
+                /// \details Dane s wczytywane do struktury drzewa, a niepoprawne wiersze s logowane. Kolejne wybranie
+                /// opcji wczytuje tylko wiersze dopisane do pliku od poprzedniego razu; wiersze o znacznikach czasu
+                /// obecnych ju w drzewie s pomijane.
+            {
+                size_t added = 0; ///< Liczba wierszy dodanych do drzewa.
+                if (!csvFollower.pollBatches([&](vector<RowData>& rows) {
+                    added += treeData.addBatch(rows, true); ///< Dodanie paczki do struktury drzewa (bez duplikatw).
+                })) {
+                    cerr << "Error opening file" << endl;
+                    return 1;
+                }
+
+                cout << "Data loaded successfully." << endl;
+                cout << "Loaded " << added << " new lines (" << treeData.size() << " in total)" << endl;
+                cout << "Found " << errorLogCount << " faulty lines" << endl;
+                cout << "Check log and log_error files for more details" << endl;
             }
+            break;
+
+            case 2:
+                /// \brief Wywietlenie struktury drzewa.
+                treeData.print(); ///< Wywietlanie struktury drzewa danych.
+                break;
+
+            case 3:
+                /// \brief Pobranie danych w okrelonym przedziale czasowym.
+                cout << "Enter start date (dd.mm.yyyy hh:mm): ";
+                getline(cin, startDate);
+                cout << "Enter end date (dd.mm.yyyy hh:mm): ";
+                getline(cin, endDate);
+                cout << "Data between " << startDate << " and " << endDate << ":" << endl;
+                treeData.viewBetweenDates(startDate, endDate).forEach(displayRow); ///< Wypisanie wierszy wprost z kolumn drzewa.
+                break;
+
+            case 4:
+                /// \brief Obliczenie sum w okrelonym przedziale czasowym.
+                cout << "Enter start date (dd.mm.yyyy hh:mm): ";
+                getline(cin, startDate);
+                cout << "Enter end date (dd.mm.yyyy hh:mm): ";
+                getline(cin, endDate);
+                treeData.calculateSumsBetweenDates(startDate, endDate, autokonsumpcjaSum, eksportSum, importSum, poborSum, produkcjaSum); ///< Obliczanie sum dla danych z przedziau czasowego.
+                cout << "Sums between " << startDate << " and " << endDate << ":" << endl;
+                cout << "Autokonsumpcja: " << autokonsumpcjaSum << endl;
+                cout << "Eksport: " << eksportSum << endl;
+                cout << "Import: " << importSum << endl;
+                cout << "Pobr: " << poborSum << endl;
+                cout << "Produkcja: " << produkcjaSum << endl;
+                break;
+
+            case 5:
+                /// \brief Obliczenie rednich w okrelonym przedziale czasowym.
+                cout << "Enter start date (dd.mm.yyyy hh:mm): ";
+                getline(cin, startDate);
+                cout << "Enter end date (dd.mm.yyyy hh:mm): ";
+                getline(cin, endDate);
+                treeData.calculateAveragesBetweenDates(startDate, endDate, autokonsumpcjaSum, eksportSum, importSum, poborSum, produkcjaSum); ///< Obliczanie rednich dla danych z przedziau czasowego.
+                cout << "Averages between " << startDate << " and " << endDate << ":" << endl;
+                cout << "Autokonsumpcja: " << autokonsumpcjaSum << endl;
+                cout << "Eksport: " << eksportSum << endl;
+                cout << "Import: " << importSum << endl;
+                cout << "Pobr: " << poborSum << endl;
+                cout << "Produkcja: " << produkcjaSum << endl;
+                break;
 
-            while (getline(file, line)) {
-                if (lineValidation(line)) {  ///< Walidacja wiersza danych.
-                    RowData rd(line);  ///< Tworzenie obiektu RowData z wiersza CSV.
-                    data.push_back(rd); ///< Dodanie wiersza do wektora danych.
-                    treeData.addData(rd);  ///< Dodanie wiersza do struktury drzewa.
+            case 6:
+                /// \brief Porwnanie danych midzy dwoma zakresami czasowymi.
+                cout << "Enter first start date (dd.mm.yyyy hh:mm): ";
+                getline(cin, startDate1);
+                cout << "Enter first end date (dd.mm.yyyy hh:mm): ";
+                getline(cin, endDate1);
+                cout << "Enter second start date (dd.mm.yyyy hh:mm): ";
+                getline(cin, startDate2);
+                cout << "Enter second end date (dd.mm.yyyy hh:mm): ";
+                getline(cin, endDate2);
+            {
+                TreeData::RangeComparison comparison = treeData.compareRanges(startDate1, endDate1, startDate2, endDate2); ///< Porwnanie danych midzy dwoma zakresami czasowymi.
+                const char* channelNames[CHANNEL_COUNT] = { "Autokonsumpcja", "Eksport", "Import", "Pobr", "Produkcja" };
+                cout << "Differences between ranges:" << endl;
+                for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                    cout << channelNames[channel] << ": " << static_cast<float>(comparison.absoluteDelta[channel]);
+                    if (!isnan(comparison.percentDelta[channel])) {  ///< NaN oznacza zerow sum w pierwszym zakresie
+                        cout << " (" << showpos << static_cast<float>(comparison.percentDelta[channel]) << noshowpos << "%)";
+                    }
+                    cout << endl;
                 }
             }
-
-            file.close();
-            cout << "Data loaded successfully." << endl;
-            cout << "Loaded " << data.size() << " lines" << endl;
-            cout << "Found " << errorLogCount << " faulty lines" << endl;
-            cout << "Check log and log_error files for more details" << endl;
             break;
 
-        case 2:
-            /// \brief Wywietlenie struktury drzewa.
-            treeData.print(); ///< Wywietlanie struktury drzewa danych.
-            break;
+            case 7:
+                /// \brief Wyszukiwanie danych w okrelonym przedziale czasowym z tolerancj.
+                cout << "Enter start date (dd.mm.yyyy hh:mm): ";
+                getline(cin, startDate);
+                cout << "Enter end date (dd.mm.yyyy hh:mm): ";
+                getline(cin, endDate);
+                cout << "Enter search value: ";
+                cin >> searchValue;
+                cout << "Enter tolerance: ";
+                cin >> tolerance;
+                cout << "Enter channel (0 - all, 1 - Autokonsumpcja, 2 - Eksport, 3 - Import, 4 - Pobr, 5 - Produkcja): ";
+                cin >> searchChannel;
+                cout << "Records within tolerance:" << endl;
+                if (searchChannel >= 1 && searchChannel <= CHANNEL_COUNT) {
+                    treeData.forEachRecordWithTolerance(startDate, endDate, searchValue, tolerance,
+                        static_cast<Channel>(searchChannel - 1), displayRow); ///< Wyszukiwanie w wybranym kanale.
+                }
+                else {
+                    treeData.forEachRecordWithTolerance(startDate, endDate, searchValue, tolerance, displayRow); ///< Wyszukiwanie rekordw z tolerancj w podanym zakresie dat.
+                }
+                break;
 
-        case 3:
-            /// \brief Pobranie danych w okrelonym przedziale czasowym.
-            cout << "Enter start date (dd.mm.yyyy hh:mm): ";
-            getline(cin, startDate);
-            cout << "Enter end date (dd.mm.yyyy hh:mm): ";
-            getline(cin, endDate);
-            filteredData = treeData.getDataBetweenDates(startDate, endDate); ///< Pobranie danych z drzewa w podanym zakresie dat.
-            cout << "Data between " << startDate << " and " << endDate << ":" << endl;
-            for (const auto& rd : filteredData) {  ///< Iteracja po danych w przedziale czasowym.
-                rd.display();  ///< Wywietlanie danych.
+            case 8:
+                /// \brief Zapisanie danych do pliku binarnego.
+            {
+                ofstream binaryFile("data.bin", ios::binary);
+                if (!binaryFile.is_open()) {
+                    cerr << "Error opening binary file" << endl;
+                    return 1;
+                }
+                treeData.saveSnapshot(binaryFile);  ///< Zapisanie kolumn danych w formacie migawki.
+                binaryFile.close();
+                treeData.saveIndex("data.idx");  ///< Zapisanie indeksu, ktry kolejne uruchomienie odwzoruje w pamici.
+                cout << "Data saved successfully." << endl;
             }
             break;
 
-        case 4:
-            /// \brief Obliczenie sum w okrelonym przedziale czasowym.
-            cout << "Enter start date (dd.mm.yyyy hh:mm): ";
-            getline(cin, startDate);
-            cout << "Enter end date (dd.mm.yyyy hh:mm): ";
-            getline(cin, endDate);
-            treeData.calculateSumsBetweenDates(startDate, endDate, autokonsumpcjaSum, eksportSum, importSum, poborSum, produkcjaSum); ///< Obliczanie sum dla danych z przedziau czasowego.
-            cout << "Sums between " << startDate << " and " << endDate << ":" << endl;
-            cout << "Autokonsumpcja: " << autokonsumpcjaSum << endl;
-            cout << "Eksport: " << eksportSum << endl;
-            cout << "Import: " << importSum << endl;
-            cout << "Pobr: " << poborSum << endl;
-            cout << "Produkcja: " << produkcjaSum << endl;
+            case 9:
+                /// \brief Wczytanie danych z pliku binarnego.
+                /// \details Jeli istnieje plik indeksu, dane s z niego odwzorowywane w pamici bez wczytywania wierszy.
+            {
+                if (treeData.openIndex("data.idx")) {
+                    cout << "Index mapped successfully." << endl;
+                    cout << "Loaded " << treeData.size() << " lines" << endl;
+                    break;
+                }
+                ifstream binaryFileIn("data.bin", ios::binary);
+                if (!binaryFileIn.is_open()) {
+                    cerr << "Error opening binary file for reading" << endl;
+                    return 1;
+                }
+                treeData.loadSnapshot(binaryFileIn);  ///< Zastpienie danych drzewa zawartoci migawki.
+                binaryFileIn.close();
+                cout << "Data loaded successfully." << endl;
+            }
             break;
 
-        case 5:
-            /// \brief Obliczenie rednich w okrelonym przedziale czasowym.
-            cout << "Enter start date (dd.mm.yyyy hh:mm): ";
-            getline(cin, startDate);
-            cout << "Enter end date (dd.mm.yyyy hh:mm): ";
-            getline(cin, endDate);
-            treeData.calculateAveragesBetweenDates(startDate, endDate, autokonsumpcjaSum, eksportSum, importSum, poborSum, produkcjaSum); ///< Obliczanie rednich dla danych z przedziau czasowego.
-            cout << "Averages between " << startDate << " and " << endDate << ":" << endl;
-            cout << "Autokonsumpcja: " << autokonsumpcjaSum << endl;
-            cout << "Eksport: " << eksportSum << endl;
-            cout << "Import: " << importSum << endl;
-            cout << "Pobr: " << poborSum << endl;
-            cout << "Produkcja: " << produkcjaSum << endl;
-            break;
+            case 10:
+                /// \brief Szereg czasowy w kubekach o wybranej szerokoci.
+                /// \details Dla kadego kubeka wypisywana jest liczba wierszy oraz rednie kanaw.
+                cout << "Enter start date (dd.mm.yyyy hh:mm): ";
+                getline(cin, startDate);
+                cout << "Enter end date (dd.mm.yyyy hh:mm): ";
+                getline(cin, endDate);
+                cout << "Enter bucket size (1 - 15 min, 2 - 1 h, 3 - 6 h, 4 - 1 day, 5 - 1 week, 6 - 1 month): ";
+                cin >> granularityChoice;
+                if (granularityChoice < 1 || granularityChoice > 6) {
+                    cout << "Invalid bucket size." << endl;
+                    break;
+                }
+                cout << "Date, rows, Autokonsumpcja, Eksport, Import, Pobr, Produkcja (averages):" << endl;
+                for (const auto& bucket : treeData.resample(startDate, endDate,
+                    static_cast<TreeData::Granularity>(granularityChoice - 1))) {  ///< Iteracja po kubekach szeregu.
+                    cout << formatTimestamp(bucket.start) << " " << bucket.stats.count;
+                    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                        cout << " " << static_cast<float>(bucket.stats.average(static_cast<Channel>(channel)));
+                    }
+                    cout << endl;
+                }
+                break;
 
-        case 6:
-            /// \brief Porwnanie danych midzy dwoma zakresami czasowymi.
-            cout << "Enter first start date (dd.mm.yyyy hh:mm): ";
-            getline(cin, startDate1);
-            cout << "Enter first end date (dd.mm.yyyy hh:mm): ";
-            getline(cin, endDate1);
-            cout << "Enter second start date (dd.mm.yyyy hh:mm): ";
-            getline(cin, startDate2);
-            cout << "Enter second end date (dd.mm.yyyy hh:mm): ";
-            getline(cin, endDate2);
-            treeData.compareDataBetweenDates(startDate1, endDate1, startDate2, endDate2, autokonsumpcjaDiff, eksportDiff, importDiff, poborDiff, produkcjaDiff); ///< Porwnanie danych midzy dwoma zakresami czasowymi.
-            cout << "Differences between ranges:" << endl;
-            cout << "Autokonsumpcja: " << autokonsumpcjaDiff << endl;
-            cout << "Eksport: " << eksportDiff << endl;
-            cout << "Import: " << importDiff << endl;
-            cout << "Pobr: " << poborDiff << endl;
-            cout << "Produkcja: " << produkcjaDiff << endl;
-            break;
+            case 11:
+                /// \brief Sumy i rednie wszystkich instalacji w przedziale czasowym.
+                /// \details Przy pierwszym uyciu pliki z argumentw programu s wczytywane jedn paczk; nazw
+                /// instalacji jest nazwa pliku.
+                if (sites.siteCount() == 0) {
+                    vector<MultiSiteData::SiteFile> siteFiles;
+                    for (int i = 1; i < argc; ++i) {
+                        siteFiles.push_back({ argv[i], argv[i] });
+                    }
+                    if (siteFiles.empty()) {
+                        siteFiles.push_back({ csvFileName, csvFileName });
+                    }
+                    cout << "Loaded " << sites.loadFiles(siteFiles) << " lines from " << sites.siteCount() << " sites" << endl;
+                }
+                cout << "Enter start date (dd.mm.yyyy hh:mm): ";
+                getline(cin, startDate);
+                cout << "Enter end date (dd.mm.yyyy hh:mm): ";
+                getline(cin, endDate);
+                {
+                    Aggregate totals = sites.calculateStatsBetweenDates(MultiSiteData::SiteSet(), startDate, endDate); ///< Statystyki wszystkich instalacji.
+                    cout << "Totals of " << sites.siteCount() << " sites (" << totals.count << " readings) between "
+                        << startDate << " and " << endDate << ":" << endl;
+                    const char* channelNames[CHANNEL_COUNT] = { "Autokonsumpcja", "Eksport", "Import", "Pobr", "Produkcja" };
+                    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                        cout << channelNames[channel] << ": sum " << totals.sum[channel]
+                            << ", average " << totals.average(static_cast<Channel>(channel)) << endl;
+                    }
+                }
+                break;
 
-        case 7:
-            /// \brief Wyszukiwanie danych w okrelonym przedziale czasowym z tolerancj.
-            cout << "Enter start date (dd.mm.yyyy hh:mm): ";
-            getline(cin, startDate);
-            cout << "Enter end date (dd.mm.yyyy hh:mm): ";
-            getline(cin, endDate);
-            cout << "Enter search value: ";
-            cin >> searchValue;
-            cout << "Enter tolerance: ";
-            cin >> tolerance;
-            recordsWithTolerance = treeData.searchRecordsWithTolerance(startDate, endDate, searchValue, tolerance); ///< Wyszukiwanie rekordw z tolerancj w podanym zakresie dat.
-            cout << "Records within tolerance:" << endl;
-            for (const auto& rd : recordsWithTolerance) {  ///< Iteracja po wynikach wyszukiwania.
-                rd.display();  ///< Wywietlanie wynikw wyszukiwania.
-            }
-            break;
+            case 12:
+                /// \brief Wyjcie z programu.
+                cout << "Exiting..." << endl;
+                return 0;
 
-        case 8:
-            /// \brief Zapisanie danych do pliku binarnego.
-        {
-            ofstream binaryFile("data.bin", ios::binary);
-            if (!binaryFile.is_open()) {
-                cerr << "Error opening binary file" << endl;
-                return 1;
-            }
-            for (const auto& rd : data) {
-                rd.saveToBinary(binaryFile);  ///< Zapisanie wiersza danych do pliku binarnego.
+            default:
+                cout << "Invalid choice. Please try again." << endl;
+                break;
             }
-            binaryFile.close();
-            cout << "Data saved successfully." << endl;
         }
-        break;
-
-        case 9:
-            /// \brief Wczytanie danych z pliku binarnego.
-        {
-            ifstream binaryFileIn("data.bin", ios::binary);
-            if (!binaryFileIn.is_open()) {
-                cerr << "Error opening binary file for reading" << endl;
-                return 1;
-            }
-            while (binaryFileIn.peek() != EOF) {
-                RowData rd(binaryFileIn);  ///< Wczytanie wiersza danych z pliku binarnego.
-                treeData.addData(rd);  ///< Dodanie wiersza danych do struktury drzewa.
-            }
-            binaryFileIn.close();
-            cout << "Data loaded successfully." << endl;
+        catch (const invalid_argument& e) {
+            cerr << e.what() << endl; ///< Bdny format daty podanej przez uytkownika.
         }
-        break;
-
-        case 10:
-            /// \brief Wyjcie z programu.
-            cout << "Exiting..." << endl;
-            return 0;
-
-        default:
-            cout << "Invalid choice. Please try again." << endl;
-            break;
+        catch (const runtime_error& e) {
+            cerr << e.what() << endl; ///< Uszkodzony lub niezgodny plik binarny.
         }
     }
 